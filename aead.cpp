@@ -0,0 +1,227 @@
+#include "aead.h"
+#include "chacha.h"
+#include "chacha_kernels.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+static inline uint32_t load32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void store32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+// --- Poly1305 ---
+//
+// Arithmetic mod 2^130 - 5 on five 26-bit limbs, so every partial product
+// fits a 64-bit accumulator without carries in between.
+
+Poly1305::Poly1305(const uint8_t key[32]) {
+    // r with the RFC clamping applied (r &= 0x0ffffffc0ffffffc0ffffffc0fffffff)
+    r[0] = load32(key + 0) & 0x3ffffff;
+    r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+    r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+    r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; ++i) pad[i] = load32(key + 16 + 4 * i);
+}
+
+void Poly1305::blocks(const uint8_t* m, size_t bytes, uint32_t hibit) {
+    const uint64_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    const uint64_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+
+    for (; bytes >= 16; bytes -= 16, m += 16) {
+        // h += m (with the 2^128 bit set for full blocks)
+        h0 += load32(m + 0) & 0x3ffffff;
+        h1 += (load32(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32(m + 12) >> 8) | hibit;
+
+        // h *= r; limbs that wrap past 2^130 come back multiplied by 5
+        uint64_t d0 = h0 * r0 + h1 * s4 + h2 * s3 + h3 * s2 + h4 * s1;
+        uint64_t d1 = h0 * r1 + h1 * r0 + h2 * s4 + h3 * s3 + h4 * s2;
+        uint64_t d2 = h0 * r2 + h1 * r1 + h2 * r0 + h3 * s4 + h4 * s3;
+        uint64_t d3 = h0 * r3 + h1 * r2 + h2 * r1 + h3 * r0 + h4 * s4;
+        uint64_t d4 = h0 * r4 + h1 * r3 + h2 * r2 + h3 * r1 + h4 * r0;
+
+        // Partial reduction
+        uint32_t c;
+        c = static_cast<uint32_t>(d0 >> 26); h0 = static_cast<uint32_t>(d0) & 0x3ffffff;
+        d1 += c; c = static_cast<uint32_t>(d1 >> 26); h1 = static_cast<uint32_t>(d1) & 0x3ffffff;
+        d2 += c; c = static_cast<uint32_t>(d2 >> 26); h2 = static_cast<uint32_t>(d2) & 0x3ffffff;
+        d3 += c; c = static_cast<uint32_t>(d3 >> 26); h3 = static_cast<uint32_t>(d3) & 0x3ffffff;
+        d4 += c; c = static_cast<uint32_t>(d4 >> 26); h4 = static_cast<uint32_t>(d4) & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+    }
+
+    h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3; h[4] = h4;
+}
+
+void Poly1305::update(const uint8_t* data, size_t len) {
+    if (len == 0) return;
+    if (buffered > 0) {
+        size_t take = std::min(len, 16 - buffered);
+        std::memcpy(buffer + buffered, data, take);
+        buffered += take;
+        data += take;
+        len -= take;
+        if (buffered < 16) return;
+        blocks(buffer, 16, 1u << 24);
+        buffered = 0;
+    }
+    size_t whole = len & ~static_cast<size_t>(15);
+    blocks(data, whole, 1u << 24);
+    std::memcpy(buffer, data + whole, len - whole);
+    buffered = len - whole;
+}
+
+void Poly1305::finish(uint8_t tag[kTagSize]) {
+    if (buffered > 0) {
+        // Final partial block: append a 1 byte, zero-fill, no 2^128 bit
+        buffer[buffered] = 1;
+        std::memset(buffer + buffered + 1, 0, 16 - buffered - 1);
+        blocks(buffer, 16, 0);
+        buffered = 0;
+    }
+
+    // Full carry
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4], c;
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // g = h + 5 - 2^130; take g when it does not borrow, i.e. h >= p (constant time)
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+    uint32_t mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // tag = (h + s) mod 2^128
+    uint32_t w0 = h0 | (h1 << 26);
+    uint32_t w1 = (h1 >> 6) | (h2 << 20);
+    uint32_t w2 = (h2 >> 12) | (h3 << 14);
+    uint32_t w3 = (h3 >> 18) | (h4 << 8);
+    uint64_t f;
+    f = static_cast<uint64_t>(w0) + pad[0];             store32(tag + 0, static_cast<uint32_t>(f));
+    f = static_cast<uint64_t>(w1) + pad[1] + (f >> 32); store32(tag + 4, static_cast<uint32_t>(f));
+    f = static_cast<uint64_t>(w2) + pad[2] + (f >> 32); store32(tag + 8, static_cast<uint32_t>(f));
+    f = static_cast<uint64_t>(w3) + pad[3] + (f >> 32); store32(tag + 12, static_cast<uint32_t>(f));
+}
+
+// --- ChaCha20-Poly1305 ---
+
+// One-time Poly1305 key: the first 32 bytes of keystream block 0
+static std::array<uint8_t, 32> polyKey(const uint8_t key[32], const uint8_t nonce[12]) {
+    uint32_t st[16];
+    ChaCha20::init_state(st, key, nonce, 0);
+    uint8_t block[64] = {0};
+    chachaKernels().xorBlocks(st, block, block, 1);
+    std::array<uint8_t, 32> otk;
+    std::memcpy(otk.data(), block, otk.size());
+    return otk;
+}
+
+static const uint8_t kZeroPad[16] = {0};
+
+ChaCha20Poly1305::ChaCha20Poly1305(const uint8_t key[32], const uint8_t nonce[12])
+    : cipher(key, nonce, 1), mac(polyKey(key, nonce).data()) {}
+
+void ChaCha20Poly1305::aad(const uint8_t* data, size_t len) {
+    mac.update(data, len);
+    aadLen += len;
+}
+
+void ChaCha20Poly1305::startPayload() {
+    if (inPayload) return;
+    mac.update(kZeroPad, (16 - aadLen % 16) % 16);
+    inPayload = true;
+}
+
+void ChaCha20Poly1305::encrypt(uint8_t* data, size_t len) {
+    startPayload();
+    cipher.process(std::span<uint8_t>(data, len));
+    mac.update(data, len);
+    dataLen += len;
+}
+
+void ChaCha20Poly1305::decrypt(uint8_t* data, size_t len) {
+    startPayload();
+    mac.update(data, len);
+    cipher.process(std::span<uint8_t>(data, len));
+    dataLen += len;
+}
+
+void ChaCha20Poly1305::finish(uint8_t tag[kTagSize]) {
+    startPayload();
+    mac.update(kZeroPad, (16 - dataLen % 16) % 16);
+    uint8_t lengths[16];
+    for (int i = 0; i < 8; ++i) {
+        lengths[i] = static_cast<uint8_t>(aadLen >> (8 * i));
+        lengths[8 + i] = static_cast<uint8_t>(dataLen >> (8 * i));
+    }
+    mac.update(lengths, sizeof(lengths));
+    mac.finish(tag);
+}
+
+bool ChaCha20Poly1305::verify(const uint8_t tag[kTagSize]) {
+    uint8_t expected[kTagSize];
+    finish(expected);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < kTagSize; ++i) diff |= expected[i] ^ tag[i];
+    return diff == 0;
+}
+
+void ChaCha20Poly1305::seal(std::span<uint8_t> data, std::span<const uint8_t> aad,
+                            const uint8_t key[32], const uint8_t nonce[12], uint8_t tag[kTagSize]) {
+    ChaCha20Poly1305 ctx(key, nonce);
+    ctx.aad(aad.data(), aad.size());
+    ctx.encrypt(data.data(), data.size());
+    ctx.finish(tag);
+}
+
+bool ChaCha20Poly1305::open(std::span<uint8_t> data, std::span<const uint8_t> aad,
+                            const uint8_t key[32], const uint8_t nonce[12], const uint8_t tag[kTagSize]) {
+    ChaCha20Poly1305 ctx(key, nonce);
+    ctx.aad(aad.data(), aad.size());
+    ctx.decrypt(data.data(), data.size());
+    if (!ctx.verify(tag)) {
+        // Never hand unauthenticated plaintext to the caller
+        std::fill(data.begin(), data.end(), 0);
+        return false;
+    }
+    return true;
+}
+
+bool ChaCha20Poly1305::check(std::span<const uint8_t> data, std::span<const uint8_t> aad,
+                             const uint8_t key[32], const uint8_t nonce[12], const uint8_t tag[kTagSize]) {
+    ChaCha20Poly1305 ctx(key, nonce);
+    ctx.aad(aad.data(), aad.size());
+    ctx.startPayload();
+    ctx.mac.update(data.data(), data.size());
+    ctx.dataLen = data.size();
+    return ctx.verify(tag);
+}
+
+void ChaCha20Poly1305::decryptChecked(std::span<uint8_t> data, const uint8_t key[32], const uint8_t nonce[12]) {
+    ChaCha20 cipher(key, nonce, 1);
+    cipher.process(data);
+}
@@ -0,0 +1,87 @@
+#ifndef AEAD_H
+#define AEAD_H
+
+#include "chacha.h"
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+// Poly1305 one-time authenticator (RFC 8439, section 2.5), fed incrementally.
+// The 32-byte key must never be reused; ChaCha20Poly1305 derives a fresh one
+// per nonce.
+class Poly1305 {
+public:
+    static constexpr size_t kTagSize = 16;
+
+    explicit Poly1305(const uint8_t key[32]);
+
+    // Absorbs `len` bytes; may be called any number of times with any split
+    void update(const uint8_t* data, size_t len);
+
+    // Pads and absorbs the final partial block and writes the tag
+    void finish(uint8_t tag[kTagSize]);
+
+private:
+    void blocks(const uint8_t* m, size_t bytes, uint32_t hibit);
+
+    uint32_t r[5];       // Clamped key, 26-bit limbs
+    uint32_t h[5] = {};  // Accumulator, 26-bit limbs
+    uint32_t pad[4];     // s, added at the end
+    uint8_t buffer[16];
+    size_t buffered = 0;
+};
+
+/**
+ * ChaCha20-Poly1305 AEAD (RFC 8439, section 2.8).
+ *
+ * The one-time Poly1305 key is keystream block 0; the payload is encrypted
+ * from block 1. The tag covers the associated data (for Quasar: the frame
+ * header) and the ciphertext, so a corrupted or forged frame is rejected
+ * before any decompression work.
+ *
+ * Streaming use: aad() first (any number of calls), then encrypt() or
+ * decrypt() over the payload in chunks of any size, then finish()/verify().
+ */
+class ChaCha20Poly1305 {
+public:
+    static constexpr size_t kTagSize = Poly1305::kTagSize;
+
+    ChaCha20Poly1305(const uint8_t key[32], const uint8_t nonce[12]);
+
+    // Associated data: authenticated, not encrypted. Must precede the payload.
+    void aad(const uint8_t* data, size_t len);
+
+    // In place: encrypt() XORs then authenticates the ciphertext, decrypt()
+    // authenticates the ciphertext then XORs
+    void encrypt(uint8_t* data, size_t len);
+    void decrypt(uint8_t* data, size_t len);
+
+    // Tag over everything fed so far (call once)
+    void finish(uint8_t tag[kTagSize]);
+
+    // finish() and a constant-time comparison against `tag`
+    bool verify(const uint8_t tag[kTagSize]);
+
+    // One-shot helpers over a buffer (encrypted/decrypted in place). open()
+    // wipes `data` and returns false on a bad tag.
+    static void seal(std::span<uint8_t> data, std::span<const uint8_t> aad,
+                     const uint8_t key[32], const uint8_t nonce[12], uint8_t tag[kTagSize]);
+    static bool open(std::span<uint8_t> data, std::span<const uint8_t> aad,
+                     const uint8_t key[32], const uint8_t nonce[12], const uint8_t tag[kTagSize]);
+    // Checks the tag of encrypted `data` without decrypting it
+    static bool check(std::span<const uint8_t> data, std::span<const uint8_t> aad,
+                      const uint8_t key[32], const uint8_t nonce[12], const uint8_t tag[kTagSize]);
+    // Decrypts `data` in place after check() has accepted it: keystream
+    // only, the tag is not computed a second time
+    static void decryptChecked(std::span<uint8_t> data, const uint8_t key[32], const uint8_t nonce[12]);
+
+private:
+    void startPayload();
+
+    ChaCha20 cipher;        // Payload keystream, from block 1
+    Poly1305 mac;
+    uint64_t aadLen = 0, dataLen = 0;
+    bool inPayload = false;
+};
+
+#endif // AEAD_H
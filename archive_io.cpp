@@ -0,0 +1,310 @@
+#include "archive_io.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <cstring>
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+
+template <typename T>
+std::span<const uint8_t> rawBytes(const T& value) {
+    return {reinterpret_cast<const uint8_t*>(&value), sizeof(T)};
+}
+
+} // namespace
+
+// --- Archives ---
+
+bool parseArchive(std::span<uint8_t> bytes, ArchiveView& view) {
+    if (bytes.size() < sizeof(QuasarHeader)) return false;
+    std::memcpy(&view.header, bytes.data(), sizeof(QuasarHeader));
+    view.bytes = bytes;
+    return std::strncmp(view.header.magic, "QSR1", 4) == 0;
+}
+
+bool MappedArchive::open(const std::string& path) {
+    if (!file.open(path)) return false;
+    if (file.bytes().size() < sizeof(QuasarHeader)) {
+        std::cerr << path << " is too short for a Quasar archive" << std::endl;
+        file.close();
+        return false;
+    }
+    if (!parseArchive(file.bytes(), parsed)) {
+        std::cerr << "Magic mismatch." << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+// --- OutputFile ---
+
+bool OutputFile::open(const std::string& target, bool append) {
+    close();
+    path = target;
+    failed = false;
+#ifdef _WIN32
+    out.open(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    const bool opened = out.is_open();
+#else
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    const bool opened = fd >= 0;
+#endif
+    if (!opened) std::cerr << "Cannot create " << path << std::endl;
+    return opened;
+}
+
+bool OutputFile::write(std::initializer_list<std::span<const uint8_t>> pieces) {
+#ifdef _WIN32
+    for (const auto& piece : pieces) out.write(reinterpret_cast<const char*>(piece.data()), piece.size());
+    if (!out) failed = true;
+#else
+    if (fd < 0 || failed) return false;
+    iovec iov[8];
+    int remaining = 0;
+    for (const auto& piece : pieces) {
+        if (piece.empty()) continue;
+        iov[remaining++] = {const_cast<uint8_t*>(piece.data()), piece.size()};
+    }
+    iovec* next = iov;
+    while (remaining > 0) {
+        ssize_t n = writev(fd, next, remaining);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Cannot write " << path << ": " << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+        }
+        // Partial write: skip the vectors already written, trim the one cut short
+        size_t done = static_cast<size_t>(n);
+        while (remaining > 0 && done >= next->iov_len) {
+            done -= next->iov_len;
+            ++next;
+            --remaining;
+        }
+        if (remaining > 0) {
+            next->iov_base = static_cast<uint8_t*>(next->iov_base) + done;
+            next->iov_len -= done;
+        }
+    }
+#endif
+    return !failed;
+}
+
+bool OutputFile::close() {
+#ifdef _WIN32
+    if (!out.is_open()) return !failed;
+    out.close();
+    if (!out) failed = true;
+#else
+    if (fd < 0) return !failed;
+    if (::close(fd) != 0) failed = true;
+    fd = -1;
+#endif
+    if (failed) std::cerr << "Writing " << path << " failed" << std::endl;
+    return !failed;
+}
+
+bool writeArchive(const std::string& path, const QuasarHeader& header, std::span<const uint8_t> payload,
+                  std::span<const uint8_t> tag) {
+    OutputFile out;
+    if (!out.open(path)) return false;
+    out.write({rawBytes(header), payload, tag});
+    return out.close();
+}
+
+// --- RecordingWriter ---
+
+bool RecordingWriter::open(const std::string& path, bool append) {
+    close();
+    entries.clear();
+    std::error_code ec;
+    if (append && std::filesystem::file_size(path, ec) > 0 && !ec) {
+        // Drop the old index (or a torn last record) and write over it
+        RecordingReader reader;
+        if (!reader.open(path)) return false;
+        entries = reader.index();
+        offset = reader.dataEnd();
+        reader.close();
+        std::filesystem::resize_file(path, offset, ec);
+        if (ec || !file.open(path, true)) {
+            std::cerr << "Cannot append to " << path << std::endl;
+            return false;
+        }
+    } else {
+        if (!file.open(path)) return false;
+        RecordingFileHeader header = {{'Q', 'S', 'R', 'M'}, kRecordingVersion, {}};
+        if (!file.write({rawBytes(header)})) return false;
+        offset = sizeof(header);
+    }
+    active = true;
+    return true;
+}
+
+bool RecordingWriter::append(std::span<const uint8_t> archive, uint64_t timestamp_us) {
+    QuasarHeader header;
+    if (archive.size() < sizeof(header)) return false;
+    std::memcpy(&header, archive.data(), sizeof(header));
+    return append(header, archive.subspan(sizeof(header)), {}, timestamp_us);
+}
+
+bool RecordingWriter::append(const QuasarHeader& header, std::span<const uint8_t> payload, std::span<const uint8_t> tag,
+                             uint64_t timestamp_us) {
+    const uint64_t size = sizeof(header) + payload.size() + tag.size();
+    if (!active || size > UINT32_MAX) return false;
+    if (!entries.empty()) timestamp_us = std::max(timestamp_us, entries.back().timestamp_us);
+
+    RecordPrefix prefix = {static_cast<uint32_t>(size), timestamp_us};
+    if (!file.write({rawBytes(prefix), rawBytes(header), payload, tag})) return false;
+
+    RecordingEntry e = {timestamp_us, offset + sizeof(prefix), prefix.size, header.sequence, header.target_id,
+                        header.est_x, header.est_y, header.est_z, header.layer, header.layer_count};
+    entries.push_back(e);
+    offset += sizeof(prefix) + size;
+    return true;
+}
+
+bool RecordingWriter::close() {
+    if (!active) return true;
+    active = false;
+    RecordingFooter footer = {offset, static_cast<uint32_t>(entries.size()), {'Q', 'S', 'R', 'I'}};
+    std::span<const uint8_t> index(reinterpret_cast<const uint8_t*>(entries.data()), entries.size() * sizeof(RecordingEntry));
+    file.write({index, rawBytes(footer)});
+    return file.close();
+}
+
+// --- RecordingReader ---
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    std::span<const uint8_t> bytes = file.bytes();
+    RecordingFileHeader header;
+    if (bytes.size() < sizeof(header)) {
+        std::cerr << path << " is too short for a Quasar recording" << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::strncmp(header.magic, "QSRM", 4) != 0 || header.version != kRecordingVersion) {
+        std::cerr << path << " is not a Quasar recording (version " << (int)kRecordingVersion << ")" << std::endl;
+        close();
+        return false;
+    }
+
+    if (!readIndex()) scanRecords();
+
+    const uint32_t count = static_cast<uint32_t>(entries.size());
+    bySequence.resize(count);
+    for (uint32_t i = 0; i < count; ++i) bySequence[i] = i;
+    // A pose without a position fix (NaN x) is in no box. Leaving it out
+    // keeps `<` a strict weak ordering for the sort and the searches.
+    byX.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!std::isnan(entries[i].est_x)) byX.push_back(i);
+    }
+    // Stable: equal keys keep recording order
+    std::stable_sort(bySequence.begin(), bySequence.end(),
+                     [&](uint32_t a, uint32_t b) { return entries[a].sequence < entries[b].sequence; });
+    std::stable_sort(byX.begin(), byX.end(), [&](uint32_t a, uint32_t b) { return entries[a].est_x < entries[b].est_x; });
+    return true;
+}
+
+bool RecordingReader::readIndex() {
+    std::span<const uint8_t> bytes = file.bytes();
+    RecordingFooter footer;
+    if (bytes.size() < sizeof(RecordingFileHeader) + sizeof(footer)) return false;
+    std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer), sizeof(footer));
+    const uint64_t indexBytes = static_cast<uint64_t>(footer.count) * sizeof(RecordingEntry);
+    // Compared without sums, so a forged offset cannot wrap around into range
+    const uint64_t beforeFooter = bytes.size() - sizeof(footer);
+    if (std::strncmp(footer.magic, "QSRI", 4) != 0 || footer.index_offset < sizeof(RecordingFileHeader) ||
+        footer.index_offset > beforeFooter || indexBytes != beforeFooter - footer.index_offset) {
+        return false;
+    }
+
+    entries.resize(footer.count);
+    std::memcpy(entries.data(), bytes.data() + footer.index_offset, indexBytes);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const RecordingEntry& e = entries[i];
+        if (e.size < sizeof(QuasarHeader) || e.offset > footer.index_offset || e.size > footer.index_offset - e.offset ||
+            (i > 0 && e.timestamp_us < entries[i - 1].timestamp_us)) {
+            entries.clear();
+            return false;
+        }
+    }
+    end = footer.index_offset;
+    return true;
+}
+
+void RecordingReader::scanRecords() {
+    // Follow the record prefixes up to the first incomplete or foreign record
+    std::span<uint8_t> bytes = file.bytes();
+    uint64_t pos = sizeof(RecordingFileHeader);
+    entries.clear();
+    rebuilt = true;
+    while (pos + sizeof(RecordPrefix) <= bytes.size()) {
+        RecordPrefix prefix;
+        std::memcpy(&prefix, bytes.data() + pos, sizeof(prefix));
+        const uint64_t start = pos + sizeof(prefix);
+        ArchiveView view;
+        if (prefix.size > bytes.size() - start || !parseArchive(bytes.subspan(start, prefix.size), view) ||
+            (!entries.empty() && prefix.timestamp_us < entries.back().timestamp_us)) {
+            break;
+        }
+        const QuasarHeader& h = view.header;
+        entries.push_back({prefix.timestamp_us, start, prefix.size, h.sequence, h.target_id,
+                           h.est_x, h.est_y, h.est_z, h.layer, h.layer_count});
+        pos = start + prefix.size;
+    }
+    end = pos;
+}
+
+void RecordingReader::close() {
+    file.close();
+    entries.clear();
+    bySequence.clear();
+    byX.clear();
+    end = 0;
+    rebuilt = false;
+}
+
+bool RecordingReader::archive(size_t i, ArchiveView& view) const {
+    if (i >= entries.size()) return false;
+    return parseArchive(file.bytes().subspan(entries[i].offset, entries[i].size), view);
+}
+
+size_t RecordingReader::seekTime(uint64_t timestamp_us) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), timestamp_us,
+                               [](const RecordingEntry& e, uint64_t t) { return e.timestamp_us < t; });
+    return static_cast<size_t>(it - entries.begin());
+}
+
+std::vector<size_t> RecordingReader::findSequence(uint32_t sequence) const {
+    auto first = std::lower_bound(bySequence.begin(), bySequence.end(), sequence,
+                                  [&](uint32_t i, uint32_t s) { return entries[i].sequence < s; });
+    auto last = std::upper_bound(first, bySequence.end(), sequence,
+                                 [&](uint32_t s, uint32_t i) { return s < entries[i].sequence; });
+    return std::vector<size_t>(first, last);  // Stable sort: already in recording order
+}
+
+std::vector<size_t> RecordingReader::findPose(const Pose& lo, const Pose& hi) const {
+    // The x ordering narrows the search to a slab; y and z are checked per entry
+    auto first = std::lower_bound(byX.begin(), byX.end(), lo.x, [&](uint32_t i, float x) { return entries[i].est_x < x; });
+    std::vector<size_t> found;
+    for (auto it = first; it != byX.end() && entries[*it].est_x <= hi.x; ++it) {
+        const RecordingEntry& e = entries[*it];
+        if (e.est_x >= lo.x && e.est_y >= lo.y && e.est_y <= hi.y && e.est_z >= lo.z && e.est_z <= hi.z) {
+            found.push_back(*it);  // est_x >= lo.x only fails for a NaN bound
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
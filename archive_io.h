@@ -0,0 +1,178 @@
+#ifndef ARCHIVE_IO_H
+#define ARCHIVE_IO_H
+
+#include <string>
+#include <span>
+#include <vector>
+#include <chrono>
+#include <initializer_list>
+#include <cstdint>
+#include <cstddef>
+#include "quasar_format.h"
+#include "mapped_file.h"
+#ifdef _WIN32
+#include <fstream>
+#endif
+
+// One archive (header, payload [+ tag]) in memory
+struct ArchiveView {
+    QuasarHeader header;         // Copied out: archives need not be aligned
+    std::span<uint8_t> bytes;    // The whole archive
+
+    // Raw header bytes, as authenticated by the AEAD
+    std::span<const uint8_t> headerBytes() const { return bytes.first(sizeof(QuasarHeader)); }
+    // Everything after the header (ciphertext + tag when encrypted)
+    std::span<uint8_t> payload() const { return bytes.subspan(sizeof(QuasarHeader)); }
+};
+
+// False if `bytes` is shorter than a header or lacks the QSR1 magic
+bool parseArchive(std::span<uint8_t> bytes, ArchiveView& view);
+
+/**
+ * Zero-copy .qsr archive access.
+ *
+ * The file is mapped and the decoders read the payload straight from the
+ * page cache, never from a buffer of their own. An encrypted payload can be
+ * decrypted in place without touching the file (see MappedFile).
+ */
+class MappedArchive {
+public:
+    // Maps `path`. Returns false (with a message on stderr) if it cannot be
+    // read, is shorter than a header or does not carry the QSR1 magic.
+    bool open(const std::string& path);
+    void close() { file.close(); }
+
+    // Valid after a successful open()
+    const ArchiveView& view() const { return parsed; }
+    const QuasarHeader& header() const { return parsed.header; }
+    std::span<const uint8_t> headerBytes() const { return parsed.headerBytes(); }
+    std::span<uint8_t> payload() { return parsed.payload(); }
+    size_t size() const { return file.bytes().size(); }
+
+private:
+    MappedFile file;
+    ArchiveView parsed{};
+};
+
+// Sequential output file. A write of several pieces goes out as one gathered
+// write (writev), so callers never assemble them into one buffer.
+class OutputFile {
+public:
+    OutputFile() = default;
+    ~OutputFile() { close(); }
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    // Creates or truncates `path`, or with `append` writes past its end
+    bool open(const std::string& path, bool append = false);
+    bool write(std::initializer_list<std::span<const uint8_t>> pieces);
+    // Returns false if any write failed or the data could not be flushed
+    bool close();
+
+private:
+    std::string path;
+    bool failed = false;
+#ifdef _WIN32
+    std::ofstream out;
+#else
+    int fd = -1;
+#endif
+};
+
+// Writes header, payload and (optional) AEAD tag to `path` with one gathered
+// write. Returns false if the file cannot be created or fully written.
+bool writeArchive(const std::string& path, const QuasarHeader& header, std::span<const uint8_t> payload,
+                  std::span<const uint8_t> tag = {});
+
+// Microseconds since the Unix epoch, the recording timestamp clock
+inline uint64_t recordingClock() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Flight recorder: appends archives to a .qsrm recording (layout in
+ * quasar_format.h). Every archive is one sequential gathered write, and the
+ * index is kept in memory until close() writes it at the end.
+ */
+class RecordingWriter {
+public:
+    RecordingWriter() = default;
+    ~RecordingWriter() { close(); }
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    // Starts a new recording at `path`, or with `append` continues an
+    // existing one (closed or cut short; a trailing partial record is
+    // discarded). Returns false if the file cannot be written or, when
+    // appending, is not a recording.
+    bool open(const std::string& path, bool append = false);
+
+    // Appends one archive, given whole or as header + payload + tag.
+    // Timestamps that would go backwards are clamped to the previous one, so
+    // the index stays sorted by time.
+    bool append(std::span<const uint8_t> archive, uint64_t timestamp_us = recordingClock());
+    bool append(const QuasarHeader& header, std::span<const uint8_t> payload, std::span<const uint8_t> tag = {},
+                uint64_t timestamp_us = recordingClock());
+
+    // Writes the index and footer. Returns false if anything failed to write.
+    bool close();
+
+    size_t frames() const { return entries.size(); }
+
+private:
+    OutputFile file;
+    bool active = false;
+    uint64_t offset = 0;  // File size so far
+    std::vector<RecordingEntry> entries;
+};
+
+// Drone position for pose queries
+struct Pose {
+    float x, y, z;
+};
+
+/**
+ * Random access to a .qsrm recording. Archives are returned as views into
+ * the mapped file. Seeking by time is a binary search over the index; image
+ * number and pose lookups use orderings built when the recording is opened.
+ */
+class RecordingReader {
+public:
+    // Returns false (with a message on stderr) if `path` is not a recording.
+    // An unclosed recording is accepted and its index rebuilt (see recovered()).
+    bool open(const std::string& path);
+    void close();
+
+    size_t size() const { return entries.size(); }
+    const std::vector<RecordingEntry>& index() const { return entries; }
+    // True if the file had no valid index and it was rebuilt by a scan
+    bool recovered() const { return rebuilt; }
+    // File offset just past the last complete record
+    uint64_t dataEnd() const { return end; }
+
+    // Archive `i` of the index; false if it is damaged
+    bool archive(size_t i, ArchiveView& view) const;
+
+    // First entry recorded at or after `timestamp_us` (size() if none)
+    size_t seekTime(uint64_t timestamp_us) const;
+    // Entries of image `sequence` (every progressive layer), in recording order
+    std::vector<size_t> findSequence(uint32_t sequence) const;
+    // Entries whose pose lies within the box [lo, hi], in recording order
+    std::vector<size_t> findPose(const Pose& lo, const Pose& hi) const;
+
+private:
+    bool readIndex();
+    void scanRecords();
+
+    MappedFile file;
+    std::vector<RecordingEntry> entries;
+    std::vector<uint32_t> bySequence;  // Entry numbers sorted by sequence
+    std::vector<uint32_t> byX;         // Entry numbers sorted by est_x (NaN left out)
+    uint64_t end = 0;
+    bool rebuilt = false;
+};
+
+#endif // ARCHIVE_IO_H
@@ -0,0 +1,84 @@
+#include "archive_io.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <vector>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+template <typename Fn>
+double mbPerSecond(size_t bytes, int iterations, Fn fn) {
+    fn(); // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    return (static_cast<double>(bytes) * iterations) / (1024.0 * 1024.0) / seconds;
+}
+
+int main() {
+    // A large flight-log archive; the file stays in the page cache, so this
+    // measures the copies and syscalls on either path, not the disk
+    const fs::path path = fs::temp_directory_path() / "quasar_bench_archive.qsr";
+    const int iterations = 20;
+    QuasarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "QSR1", 4);
+    std::vector<uint8_t> payload(64u << 20);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i * 131 + (i >> 12));
+    uint64_t checksum = 0;
+
+    std::cout << "Archive of " << (payload.size() >> 20) << " MiB" << std::endl;
+    std::cout << std::setw(28) << "path" << std::setw(12) << "MB/s" << std::endl;
+
+    // Write: assemble the archive in one buffer, or gather it straight from
+    // header and payload
+    double copyWrite = mbPerSecond(payload.size(), iterations, [&] {
+        std::vector<uint8_t> archive(sizeof(header) + payload.size());
+        std::memcpy(archive.data(), &header, sizeof(header));
+        std::memcpy(archive.data() + sizeof(header), payload.data(), payload.size());
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(archive.data()), archive.size());
+    });
+    double gatherWrite = mbPerSecond(payload.size(), iterations, [&] { writeArchive(path.string(), header, payload); });
+    // The same bytes as 64 one-MiB frames appended to a flight recording
+    const size_t frame = 1u << 20;
+    double recordWrite = mbPerSecond(payload.size(), iterations, [&] {
+        RecordingWriter recorder;
+        recorder.open(path.string());
+        for (size_t off = 0; off < payload.size(); off += frame) {
+            recorder.append(header, std::span<const uint8_t>(payload).subspan(off, frame));
+        }
+        recorder.close();
+    });
+
+    // Read: header + istreambuf_iterator slurp, or map; both then read every
+    // cache line, as a decoder would
+    writeArchive(path.string(), header, payload);
+    double streamRead = mbPerSecond(payload.size(), iterations, [&] {
+        std::ifstream in(path, std::ios::binary);
+        QuasarHeader h;
+        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        for (size_t i = 0; i < data.size(); i += 64) checksum += data[i];
+    });
+    double mappedRead = mbPerSecond(payload.size(), iterations, [&] {
+        MappedArchive archive;
+        archive.open(path.string());
+        std::span<uint8_t> data = archive.payload();
+        for (size_t i = 0; i < data.size(); i += 64) checksum += data[i];
+    });
+
+    std::cout << std::fixed << std::setprecision(0)
+              << std::setw(28) << "write: buffer + ofstream" << std::setw(12) << copyWrite << std::endl
+              << std::setw(28) << "write: writev" << std::setw(12) << gatherWrite << std::endl
+              << std::setw(28) << "record: 64 x 1 MiB frames" << std::setw(12) << recordWrite << std::endl
+              << std::setw(28) << "read: istreambuf_iterator" << std::setw(12) << streamRead << std::endl
+              << std::setw(28) << "read: mmap" << std::setw(12) << mappedRead << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    fs::remove(path);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "fec.h"
+#include "gf256_kernels.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+template <typename Fn>
+double bestSeconds(Fn fn) {
+    const int iterations = 50;
+    fn(); // warm-up
+    double best = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main() {
+    // 1. Region multiply-accumulate over one chunk-sized shard set (~1 MB)
+    const size_t shard = 1400;
+    const size_t shards = 750;
+    std::vector<uint8_t> src(shard * shards), dst(shard * shards);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<uint8_t>(i * 31 + 7);
+
+    std::cout << "GF(256) mulAdd on " << src.size() / 1024 << " KB" << std::endl;
+    std::cout << std::setw(12) << "Kernels" << std::setw(14) << "MB/s" << std::endl;
+    const Gf256Kernels* sets[] = {&gf256ScalarKernels(), &gf256Kernels()};
+    for (const Gf256Kernels* k : sets) {
+        double s = bestSeconds([&] { k->mulAdd(dst.data(), src.data(), 0x53, src.size()); });
+        std::cout << std::setw(12) << k->name << std::fixed << std::setprecision(1)
+                  << std::setw(14) << src.size() / s / 1e6 << std::endl;
+    }
+
+    // 2. Encode and worst-case recovery for one frame of 1400-byte chunks
+    std::cout << std::endl << "Reed-Solomon on a " << src.size() / 1024 << " KB frame" << std::endl;
+    std::cout << std::setw(8) << "(k,m)" << std::setw(14) << "encode MB/s" << std::setw(14) << "recover MB/s" << std::endl;
+    const int codes[][2] = {{8, 2}, {16, 4}, {32, 8}};
+    for (const auto& code : codes) {
+        const int k = code[0], m = code[1];
+        const size_t groups = shards / k;
+        std::vector<uint8_t> parity(groups * m * shard), work;
+        std::vector<size_t> sizes(k, shard);
+        auto encodeAll = [&] {
+            for (size_t g = 0; g < groups; ++g) {
+                const uint8_t* in[256];
+                uint8_t* out[256];
+                for (int j = 0; j < k; ++j) in[j] = src.data() + (g * k + j) * shard;
+                for (int r = 0; r < m; ++r) out[r] = parity.data() + (g * m + r) * shard;
+                fecEncode(in, sizes.data(), k, out, m, shard);
+            }
+        };
+        double encode = bestSeconds(encodeAll);
+
+        // Every group loses its first m data chunks. Recovery uses the parity
+        // as scratch, so repeat runs decode garbage, at the same cost.
+        work = parity;
+        std::vector<uint8_t> data = src;
+        double recover = bestSeconds([&] {
+            for (size_t g = 0; g < groups; ++g) {
+                uint8_t* in[256];
+                uint8_t* out[256];
+                bool dataPresent[256], parityPresent[256];
+                for (int j = 0; j < k; ++j) {
+                    in[j] = data.data() + (g * k + j) * shard;
+                    dataPresent[j] = j >= m;
+                }
+                for (int r = 0; r < m; ++r) {
+                    out[r] = work.data() + (g * m + r) * shard;
+                    parityPresent[r] = true;
+                }
+                fecRecover(in, dataPresent, k, out, parityPresent, m, shard);
+            }
+        });
+        std::cout << std::setw(5) << k << "," << std::setw(2) << m << std::fixed << std::setprecision(1)
+                  << std::setw(14) << groups * k * shard / encode / 1e6
+                  << std::setw(14) << groups * k * shard / recover / 1e6 << std::endl;
+    }
+    return 0;
+}
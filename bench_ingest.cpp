@@ -0,0 +1,95 @@
+#include "frame_ingest.h"
+#include "pnm_io.h"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+template <typename Fn>
+double framesPerSecond(int frames, Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return frames / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main() {
+    // 500 8-bit 720p frames handed from a capture loop to the encoder's
+    // source, without the encoder: this is the cost of getting each frame in
+    const int frames = 500, width = 1280, height = 720;
+    const size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> camera(pixels);
+    for (size_t i = 0; i < pixels; ++i) camera[i] = static_cast<uint8_t>(i * 7 + (i >> 10));
+    GrayImage capture(width, height), img(0, 0);
+    for (size_t i = 0; i < pixels; ++i) capture.data[i] = camera[i];
+
+    std::cout << frames << " frames of " << width << "x" << height << std::endl;
+    std::cout << std::setw(28) << "path" << std::setw(12) << "fps" << std::setw(12) << "us/frame" << std::endl;
+    auto row = [](const char* name, double fps) {
+        std::cout << std::setw(28) << name << std::setw(12) << std::fixed << std::setprecision(0) << fps
+                  << std::setw(12) << 1e6 / fps << std::endl;
+    };
+
+    // A PGM written and read back per frame (before process startup, which
+    // the old per-frame `quasar` invocation paid on top)
+    const fs::path pgm = fs::temp_directory_path() / "quasar_bench_ingest.pgm";
+    row("PGM file per frame", framesPerSecond(frames, [&] {
+        for (int n = 0; n < frames; ++n) {
+            savePGM(pgm.string(), capture);
+            loadPGM(pgm.string(), img);
+        }
+    }));
+    fs::remove(pgm);
+
+    // Raw frames through a named pipe
+    const fs::path fifo = fs::temp_directory_path() / "quasar_bench_ingest.fifo";
+    fs::remove(fifo);
+    mkfifo(fifo.c_str(), 0600);
+    row("raw frames over a FIFO", framesPerSecond(frames, [&] {
+        std::thread producer([&] {
+            std::FILE* out = std::fopen(fifo.c_str(), "wb");
+            FrameDescriptor d = {};
+            std::memcpy(d.magic, "QSRF", 4);
+            d.width = width;
+            d.height = height;
+            for (int n = 0; n < frames; ++n) {
+                d.sequence = n;
+                std::fwrite(&d, sizeof(d), 1, out);
+                std::fwrite(camera.data(), 1, camera.size(), out);
+            }
+            std::fclose(out);
+        });
+        RawFrameReader reader;
+        reader.open(fifo.string());
+        while (reader.next(img)) {}
+        producer.join();
+    }));
+    fs::remove(fifo);
+
+    // Shared-memory ring: the producer writes into the slot, the consumer
+    // converts out of it
+    row("shared-memory ring", framesPerSecond(frames, [&] {
+        FrameRingWriter writer;
+        writer.create("/quasar_bench_ingest", 4, pixels);
+        FrameRingReader reader;
+        reader.open("/quasar_bench_ingest");
+        std::thread producer([&] {
+            for (int n = 0; n < frames; ++n) {
+                std::memcpy(writer.claim(width, height), camera.data(), camera.size());
+                writer.publish();
+            }
+            writer.close();
+        });
+        while (reader.next(img)) {}
+        producer.join();
+    }));
+    return 0;
+}
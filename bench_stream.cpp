@@ -0,0 +1,54 @@
+#include "stream_encoder.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <thread>
+
+int main() {
+    // 200 frames of 1280x720 from memory: isolates the encoder from disk I/O
+    const int frames = 200, width = 1280, height = 720;
+    GrayImage base(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            base.data[y * width + x] = 128.0f + 60.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f) + ((x * 7 + y * 13) % 17);
+        }
+    }
+
+    StreamConfig config;
+    config.levels = 4;
+    config.scale = 100.0f;
+    config.targets = {{640, 360, 200}, {200, 150, 80}};
+    config.encrypt = true;
+    config.width = width;
+    config.height = height;
+
+    std::cout << "Streaming " << frames << " frames of " << width << "x" << height
+              << " (" << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+    for (bool pipelined : {false, true}) {
+        int n = 0;
+        FrameSource source = [&](GrayImage& img) {
+            if (n++ == frames) return false;
+            img.width = base.width;
+            img.height = base.height;
+            img.data = base.data;  // Copies into the slot's existing storage
+            return true;
+        };
+        size_t bytes = 0;
+        FrameSink sink = [&](const std::vector<uint8_t>& archive) { bytes += archive.size(); };
+        StreamEncoder encoder(config);
+        StreamStats stats = pipelined ? encoder.run(source, sink) : encoder.runSerial(source, sink);
+
+        std::cout << std::endl << (pipelined ? "Pipelined" : "Serial") << ": " << std::fixed << std::setprecision(1)
+                  << stats.fps() << " fps, " << bytes / stats.frames << " bytes/frame" << std::endl;
+        std::cout << std::setw(12) << "stage" << std::setw(10) << "mean us" << std::setw(10) << "p50 us"
+                  << std::setw(10) << "p99 us" << std::endl;
+        auto row = [](const char* name, const LatencyHistogram& h) {
+            std::cout << std::setw(12) << name << std::setprecision(0) << std::setw(10) << h.meanMicros()
+                      << std::setw(10) << h.percentileMicros(50) << std::setw(10) << h.percentileMicros(99) << std::endl;
+        };
+        for (int s = 0; s < StreamStats::kStages; ++s) row(StreamStats::stageName(s), stats.stage[s]);
+        row("end-to-end", stats.endToEnd);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "tile_codec.h"
+#include "coeff_codec.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <string>
+
+template <typename Fn>
+double msPerFrame(int iterations, Fn fn) {
+    fn(); // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+int main() {
+    // 4K frame, two ROIs: most of the frame lies outside both
+    const int width = 3840, height = 2160, levels = 4;
+    const float scale = 100.0f;
+    GrayImage src(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            src.data[y * width + x] = 128.0f + 60.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f) + ((x * 7 + y * 13) % 17);
+        }
+    }
+    std::vector<ROI> rois = {{1200, 800, 300}, {2900, 1500, 200}};
+
+    std::cout << "3840x2160, " << levels << " levels, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    size_t wholeBytes = 0;
+    double wholeMs = msPerFrame(3, [&] {
+        GrayImage img = src;
+        transform2D(img, levels);
+        applySubbandSaliency(img, rois, levels);
+        CoefficientCodec codec;
+        wholeBytes = codec.encode(quantizeCoefficients(img, scale, 0.0f, levels), width, height, levels).size();
+    });
+    std::cout << std::setw(16) << "whole frame" << std::fixed << std::setprecision(1) << std::setw(10) << wholeMs
+              << " ms encode" << std::setw(12) << wholeBytes << " bytes" << std::endl;
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        ThreadPool pool(threads);
+        TileCoding coding;
+        coding.levels = levels;
+        coding.scale = scale;
+        std::vector<uint8_t> data;
+        double encodeMs = msPerFrame(3, [&] { data = encodeTiles(src, rois, coding, pool); });
+        GrayImage out(width, height);
+        double decodeMs = msPerFrame(3, [&] { decodeTiles(data, levels, scale, 0.0f, out, pool); });
+        TileIndex index;
+        readTileIndex(data, width, height, index);
+        std::cout << std::setw(16) << ("tiled, " + std::to_string(threads) + " thr") << std::setw(10) << encodeMs << " ms encode"
+                  << std::setw(12) << data.size() << " bytes" << std::setw(10) << decodeMs << " ms decode, "
+                  << index.skipped() << "/" << index.tiles.size() << " tiles skipped" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "wavelet.h"
+#include "haar_kernels.h"
+#include "quant_kernels.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Reference: the original per-column copy-out / copy-in forward transform,
+// kept here only to show what the tiled column pass buys us.
+void referenceTransform2D(GrayImage& img) {
+    for (int y = 0; y < img.height; ++y) {
+        std::vector<float> row(img.data.begin() + y * img.width, img.data.begin() + (y + 1) * img.width);
+        haar1D(row, img.width);
+        std::copy(row.begin(), row.end(), img.data.begin() + y * img.width);
+    }
+    for (int x = 0; x < img.width; ++x) {
+        std::vector<float> col(img.height);
+        for (int y = 0; y < img.height; ++y) col[y] = img.data[y * img.width + x];
+        haar1D(col, img.height);
+        for (int y = 0; y < img.height; ++y) img.data[y * img.width + x] = col[y];
+    }
+}
+
+template <typename Fn>
+double msPerFrame(GrayImage& img, int iterations, Fn fn) {
+    fn(img); // warm-up
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(img);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+// Streams `bytes` through a kernel call repeatedly; returns GB/s of loads + stores.
+template <typename Fn>
+double gbPerSecond(size_t bytes, Fn fn) {
+    const int iterations = 200;
+    fn();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    return static_cast<double>(bytes) * iterations / seconds / 1e9;
+}
+
+void benchKernels() {
+    // 64K samples per line: 256 KB in + 256 KB out, resident in L2
+    const int n = 1 << 15;
+    std::vector<float> in(2 * n), lo(n), hi(n), out(2 * n);
+    for (int i = 0; i < 2 * n; ++i) in[i] = static_cast<float>(i % 255);
+    const size_t bytes = 4 * sizeof(float) * n;
+
+    const HaarKernels* sets[] = {&haarScalarKernels(), &haarKernels()};
+    std::cout << "Haar kernel throughput, GB/s" << std::endl;
+    std::cout << std::setw(12) << "Kernels"
+              << std::setw(14) << "ForwardRow"
+              << std::setw(14) << "InverseRow"
+              << std::setw(14) << "ForwardPair"
+              << std::setw(14) << "InversePair" << std::endl;
+    for (const HaarKernels* k : sets) {
+        double fr = gbPerSecond(bytes, [&] { k->forwardRow(in.data(), lo.data(), hi.data(), n); });
+        double ir = gbPerSecond(bytes, [&] { k->inverseRow(lo.data(), hi.data(), out.data(), n); });
+        double fp = gbPerSecond(bytes, [&] { k->forwardPair(in.data(), in.data() + n, lo.data(), hi.data(), n); });
+        double ip = gbPerSecond(bytes, [&] { k->inversePair(lo.data(), hi.data(), out.data(), out.data() + n, n); });
+        std::cout << std::setw(12) << k->name << std::fixed << std::setprecision(2)
+                  << std::setw(14) << fr << std::setw(14) << ir
+                  << std::setw(14) << fp << std::setw(14) << ip << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::vector<int32_t> q(n);
+    const size_t qbytes = (sizeof(float) + sizeof(int32_t)) * n;
+    const QuantKernels* qsets[] = {&quantScalarKernels(), &quantKernels()};
+    std::cout << "Quantization kernel throughput, GB/s" << std::endl;
+    std::cout << std::setw(12) << "Kernels"
+              << std::setw(14) << "Quantize"
+              << std::setw(14) << "Dequantize" << std::endl;
+    for (const QuantKernels* k : qsets) {
+        double qz = gbPerSecond(qbytes, [&] { k->quantize(in.data(), q.data(), n, 1000.0f); });
+        double dq = gbPerSecond(qbytes, [&] { k->dequantize(q.data(), out.data(), n, 0.001f); });
+        std::cout << std::setw(12) << k->name << std::fixed << std::setprecision(2)
+                  << std::setw(14) << qz << std::setw(14) << dq << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main() {
+    benchKernels();
+
+    const int sizes[][2] = {{640, 480}, {1920, 1080}, {4096, 3072}};
+
+    std::cout << "Haar 2D transform, ms per frame" << std::endl;
+    std::cout << std::setw(12) << "Resolution"
+              << std::setw(14) << "Reference"
+              << std::setw(14) << "Forward"
+              << std::setw(14) << "Inverse" << std::endl;
+
+    for (const auto& s : sizes) {
+        GrayImage img(s[0], s[1]);
+        for (int y = 0; y < img.height; ++y) {
+            for (int x = 0; x < img.width; ++x) {
+                img.data[y * img.width + x] = 128.0f + 60.0f * std::sin(x * 0.05f) * std::cos(y * 0.03f);
+            }
+        }
+
+        // Scale the iteration count so every resolution runs for a similar time.
+        int iterations = std::max(3, static_cast<int>(200000000LL / (static_cast<long long>(s[0]) * s[1] * 10)));
+
+        GrayImage ref = img;
+        double refMs = msPerFrame(ref, iterations, referenceTransform2D);
+        GrayImage fwd = img;
+        double fwdMs = msPerFrame(fwd, iterations, [](GrayImage& im) { transform2D(im); });
+        GrayImage inv = img;
+        double invMs = msPerFrame(inv, iterations, [](GrayImage& im) { inverseTransform2D(im); });
+
+        std::cout << std::setw(12) << (std::to_string(s[0]) + "x" + std::to_string(s[1]))
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << refMs
+                  << std::setw(14) << fwdMs
+                  << std::setw(14) << invMs << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef BIT_IO_H
+#define BIT_IO_H
+
+#include <vector>
+#include <cstdint>
+
+// MSB-first raw bit packing for fixed-width fields (up to 32 bits per call).
+// The Huffman coder has its own word-at-a-time reader/writer; these are for
+// side streams such as sign/magnitude bits and bit-packed subbands.
+
+class BitPacker {
+public:
+    std::vector<uint8_t> data;
+
+    void write(uint32_t value, int bits) {
+        if (bits == 0) return;
+        acc = (acc << bits) | (value & ((1ull << bits) - 1));
+        count += bits;
+        while (count >= 8) {
+            count -= 8;
+            data.push_back(static_cast<uint8_t>(acc >> count));
+        }
+    }
+
+    // Pads the last partial byte with zeros
+    void flush() {
+        if (count > 0) data.push_back(static_cast<uint8_t>(acc << (8 - count)));
+        count = 0;
+    }
+
+    // Starts over, keeping data's storage
+    void clear() {
+        data.clear();
+        acc = 0;
+        count = 0;
+    }
+
+private:
+    uint64_t acc = 0;
+    int count = 0;
+};
+
+class BitUnpacker {
+public:
+    BitUnpacker(const uint8_t* p, const uint8_t* end) : p(p), end(end) {}
+
+    // Returns false if the stream runs out
+    bool read(int bits, uint32_t& value) {
+        while (count < bits) {
+            if (p >= end) return false;
+            acc = (acc << 8) | *p++;
+            count += 8;
+        }
+        count -= bits;
+        value = static_cast<uint32_t>((acc >> count) & ((1ull << bits) - 1));
+        return true;
+    }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    uint64_t acc = 0;
+    int count = 0;
+};
+
+#endif // BIT_IO_H
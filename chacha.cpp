@@ -1,44 +1,9 @@
 #include "chacha.h"
+#include "chacha_kernels.h"
+#include <algorithm>
 #include <cstring>
 
-// Rotate Left using std::rotl (C++20)
-inline uint32_t rotl(uint32_t x, int n) {
-    return std::rotl(x, n);
-}
-
-void ChaCha20::quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
-    a += b; d ^= a; d = rotl(d, 16);
-    c += d; b ^= c; b = rotl(b, 12);
-    a += b; d ^= a; d = rotl(d, 8);
-    c += d; b ^= c; b = rotl(b, 7);
-}
-
-void ChaCha20::generate_block(uint32_t block[16], const uint32_t state[16]) {
-    uint32_t x[16];
-    std::memcpy(x, state, 16 * sizeof(uint32_t));
-
-    // 20 rounds (10 iterations of 2 rounds each)
-    for (int i = 0; i < 10; ++i) {
-        // Column rounds
-        quarter_round(x[0], x[4], x[8], x[12]);
-        quarter_round(x[1], x[5], x[9], x[13]);
-        quarter_round(x[2], x[6], x[10], x[14]);
-        quarter_round(x[3], x[7], x[11], x[15]);
-        // Diagonal rounds
-        quarter_round(x[0], x[5], x[10], x[15]);
-        quarter_round(x[1], x[6], x[11], x[12]);
-        quarter_round(x[2], x[7], x[8], x[13]);
-        quarter_round(x[3], x[4], x[9], x[14]);
-    }
-
-    for (int i = 0; i < 16; ++i) {
-        block[i] = x[i] + state[i];
-    }
-}
-
-void ChaCha20::process(std::vector<uint8_t>& data, const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
-    uint32_t state[16];
-    
+void ChaCha20::init_state(uint32_t state[16], const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
     // Constants: "expand 32-byte k"
     state[0] = 0x61707865;
     state[1] = 0x3320646e;
@@ -53,20 +18,58 @@ void ChaCha20::process(std::vector<uint8_t>& data, const uint8_t key[32], const
 
     // Nonce
     std::memcpy(&state[13], nonce, 12);
+}
 
-    uint32_t block[16];
-    size_t data_pos = 0;
-    size_t data_len = data.size();
+ChaCha20::ChaCha20(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) : counter0(counter) {
+    init_state(state, key, nonce, counter);
+}
+
+void ChaCha20::seek(uint64_t offset) {
+    pos = offset;
+    state[12] = counter0 + static_cast<uint32_t>(offset / 64);
+    if (pos % 64 != 0) {
+        // Mid-block: materialize the block and step past it
+        std::memset(keystream, 0, sizeof(keystream));
+        chachaKernels().xorBlocks(state, keystream, keystream, 1);
+        state[12]++;
+    }
+}
 
-    while (data_pos < data_len) {
-        generate_block(block, state);
-        state[12]++; // Increment block counter
+void ChaCha20::process(std::span<uint8_t> data) {
+    process(data, data);
+}
 
-        uint8_t keystream[64];
-        std::memcpy(keystream, block, 64);
+void ChaCha20::process(std::span<const uint8_t> in, std::span<uint8_t> out) {
+    const uint8_t* src = in.data();
+    uint8_t* dst = out.data();
+    size_t len = std::min(in.size(), out.size());
 
-        for (int i = 0; i < 64 && data_pos < data_len; ++i, ++data_pos) {
-            data[data_pos] ^= keystream[i];
-        }
+    // Finish the block left over from the previous call
+    while (len > 0 && pos % 64 != 0) {
+        *dst++ = *src++ ^ keystream[pos++ % 64];
+        --len;
     }
+
+    // Whole blocks straight through the SIMD kernels
+    size_t blocks = len / 64;
+    chachaKernels().xorBlocks(state, src, dst, blocks);
+    state[12] += static_cast<uint32_t>(blocks);
+    pos += blocks * 64;
+    src += blocks * 64;
+    dst += blocks * 64;
+    len -= blocks * 64;
+
+    // Start a new block and keep what this call does not use
+    if (len > 0) {
+        std::memset(keystream, 0, sizeof(keystream));
+        chachaKernels().xorBlocks(state, keystream, keystream, 1);
+        state[12]++;
+        for (size_t i = 0; i < len; ++i) dst[i] = src[i] ^ keystream[i];
+        pos += len;
+    }
+}
+
+void ChaCha20::process(std::vector<uint8_t>& data, const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
+    ChaCha20 cipher(key, nonce, counter);
+    cipher.process(std::span<uint8_t>(data));
 }
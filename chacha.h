@@ -2,20 +2,40 @@
 #define CHACHA_H
 
 #include <vector>
+#include <span>
 #include <cstdint>
-#include <bit>
 
 class ChaCha20 {
 public:
+    // Incremental cipher context. The keystream position is a byte offset
+    // from the initial block counter, so a stream can be processed in
+    // pieces of any size, in order or (after seek) out of order.
+    ChaCha20(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter = 1);
+
+    // Moves the keystream to byte `offset` of the stream
+    void seek(uint64_t offset);
+    uint64_t position() const { return pos; }
+
+    // XORs the keystream into `data` (in place) or from `in` into `out`
+    // (same size; may alias) and advances the position
+    void process(std::span<uint8_t> data);
+    void process(std::span<const uint8_t> in, std::span<uint8_t> out);
+
     // Encrypts/Decrypts data in-place using the given key and nonce.
     // key: 32 bytes (256-bit)
     // nonce: 12 bytes (96-bit RFC 7539 format)
     // counter: Initial block counter (usually 0 or 1)
+    // Whole blocks go through the SIMD kernels (see chacha_kernels.h).
     static void process(std::vector<uint8_t>& data, const uint8_t key[32], const uint8_t nonce[12], uint32_t counter = 1);
 
+    // RFC 7539 initial state: constants, key, block counter, nonce
+    static void init_state(uint32_t state[16], const uint8_t key[32], const uint8_t nonce[12], uint32_t counter);
+
 private:
-    static void quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d);
-    static void generate_block(uint32_t block[16], const uint32_t state[16]);
+    uint32_t state[16];     // state[12] = block containing `pos`
+    uint32_t counter0;      // Block counter at offset 0
+    uint64_t pos = 0;
+    uint8_t keystream[64];  // Current block, valid while pos % 64 != 0
 };
 
 #endif // CHACHA_H
@@ -0,0 +1,307 @@
+#include "chacha_kernels.h"
+#include "cpu_features.h"
+#include <bit>
+#include <cstring>
+
+#if defined(QUASAR_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON)
+#include <arm_neon.h>
+#endif
+
+// --- Scalar reference ---
+
+static inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+    a += b; d ^= a; d = std::rotl(d, 16);
+    c += d; b ^= c; b = std::rotl(b, 12);
+    a += b; d ^= a; d = std::rotl(d, 8);
+    c += d; b ^= c; b = std::rotl(b, 7);
+}
+
+static void generateBlock(uint32_t block[16], const uint32_t state[16]) {
+    uint32_t x[16];
+    std::memcpy(x, state, 16 * sizeof(uint32_t));
+
+    // 20 rounds (10 iterations of 2 rounds each)
+    for (int i = 0; i < 10; ++i) {
+        // Column rounds
+        quarterRound(x[0], x[4], x[8], x[12]);
+        quarterRound(x[1], x[5], x[9], x[13]);
+        quarterRound(x[2], x[6], x[10], x[14]);
+        quarterRound(x[3], x[7], x[11], x[15]);
+        // Diagonal rounds
+        quarterRound(x[0], x[5], x[10], x[15]);
+        quarterRound(x[1], x[6], x[11], x[12]);
+        quarterRound(x[2], x[7], x[8], x[13]);
+        quarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        block[i] = x[i] + state[i];
+    }
+}
+
+static void xorBlocksScalar(const uint32_t state[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint32_t st[16];
+    std::memcpy(st, state, sizeof(st));
+    for (size_t b = 0; b < blocks; ++b, in += 64, out += 64) {
+        uint32_t block[16];
+        generateBlock(block, st);
+        st[12]++;
+
+        // Word-wide XOR; the keystream words serialize little-endian
+        for (int i = 0; i < 64; i += 8) {
+            uint64_t ks, v;
+            std::memcpy(&ks, reinterpret_cast<const uint8_t*>(block) + i, 8);
+            std::memcpy(&v, in + i, 8);
+            v ^= ks;
+            std::memcpy(out + i, &v, 8);
+        }
+    }
+}
+
+// --- SSE2 (4 blocks) ---
+
+#if defined(QUASAR_X86)
+template <int N>
+QUASAR_TARGET_SSE2 static inline __m128i rotl128(__m128i x) {
+    return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N));
+}
+
+QUASAR_TARGET_SSE2
+static inline void quarterRoundSSE2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a);
+    d = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xB1), 0xB1); // rotl 16
+    c = _mm_add_epi32(c, d); b = rotl128<12>(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(a, b); d = rotl128<8>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d); b = rotl128<7>(_mm_xor_si128(b, c));
+}
+
+// Turns four word vectors (word i of blocks 0..3) into four block rows
+// (words i..i+3 of one block)
+QUASAR_TARGET_SSE2
+static inline void transpose4(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    __m128i t0 = _mm_unpacklo_epi32(a, b);
+    __m128i t1 = _mm_unpacklo_epi32(c, d);
+    __m128i t2 = _mm_unpackhi_epi32(a, b);
+    __m128i t3 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(t0, t1);
+    b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3);
+    d = _mm_unpackhi_epi64(t2, t3);
+}
+
+QUASAR_TARGET_SSE2
+static void xorBlocksSSE2(const uint32_t state[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint32_t st[16];
+    std::memcpy(st, state, sizeof(st));
+
+    for (; blocks >= 4; blocks -= 4, in += 256, out += 256) {
+        __m128i s[16], x[16];
+        for (int i = 0; i < 16; ++i) s[i] = _mm_set1_epi32(static_cast<int>(st[i]));
+        s[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+        for (int i = 0; i < 16; ++i) x[i] = s[i];
+
+        for (int r = 0; r < 10; ++r) {
+            quarterRoundSSE2(x[0], x[4], x[8], x[12]);
+            quarterRoundSSE2(x[1], x[5], x[9], x[13]);
+            quarterRoundSSE2(x[2], x[6], x[10], x[14]);
+            quarterRoundSSE2(x[3], x[7], x[11], x[15]);
+            quarterRoundSSE2(x[0], x[5], x[10], x[15]);
+            quarterRoundSSE2(x[1], x[6], x[11], x[12]);
+            quarterRoundSSE2(x[2], x[7], x[8], x[13]);
+            quarterRoundSSE2(x[3], x[4], x[9], x[14]);
+        }
+        for (int i = 0; i < 16; ++i) x[i] = _mm_add_epi32(x[i], s[i]);
+
+        // After the transpose x[4g + k] holds words 4g..4g+3 of block k
+        for (int g = 0; g < 16; g += 4) {
+            transpose4(x[g], x[g + 1], x[g + 2], x[g + 3]);
+            for (int k = 0; k < 4; ++k) {
+                const size_t off = 64 * k + 4 * g;
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + off));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + off), _mm_xor_si128(v, x[g + k]));
+            }
+        }
+        st[12] += 4;
+    }
+    xorBlocksScalar(st, in, out, blocks);
+}
+
+// --- AVX2 (8 blocks) ---
+
+template <int N>
+QUASAR_TARGET_AVX2 static inline __m256i rotl256(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+// Rotations by 16 and 8 are whole-byte moves: one shuffle instead of two shifts
+QUASAR_TARGET_AVX2
+static inline void quarterRoundAVX2(__m256i& a, __m256i& b, __m256i& c, __m256i& d,
+                                    __m256i rot16, __m256i rot8) {
+    a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);
+    c = _mm256_add_epi32(c, d); b = rotl256<12>(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot8);
+    c = _mm256_add_epi32(c, d); b = rotl256<7>(_mm256_xor_si256(b, c));
+}
+
+// 4x4 word transpose inside each 128-bit lane: lane 0 covers blocks 0..3,
+// lane 1 blocks 4..7
+QUASAR_TARGET_AVX2
+static inline void transpose4(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+    __m256i t0 = _mm256_unpacklo_epi32(a, b);
+    __m256i t1 = _mm256_unpacklo_epi32(c, d);
+    __m256i t2 = _mm256_unpackhi_epi32(a, b);
+    __m256i t3 = _mm256_unpackhi_epi32(c, d);
+    a = _mm256_unpacklo_epi64(t0, t1);
+    b = _mm256_unpackhi_epi64(t0, t1);
+    c = _mm256_unpacklo_epi64(t2, t3);
+    d = _mm256_unpackhi_epi64(t2, t3);
+}
+
+QUASAR_TARGET_AVX2
+static inline void xor32(const uint8_t* in, uint8_t* out, __m256i ks) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_xor_si256(v, ks));
+}
+
+QUASAR_TARGET_AVX2
+static void xorBlocksAVX2(const uint32_t state[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    uint32_t st[16];
+    std::memcpy(st, state, sizeof(st));
+
+    for (; blocks >= 8; blocks -= 8, in += 512, out += 512) {
+        __m256i s[16], x[16];
+        for (int i = 0; i < 16; ++i) s[i] = _mm256_set1_epi32(static_cast<int>(st[i]));
+        s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        for (int i = 0; i < 16; ++i) x[i] = s[i];
+
+        for (int r = 0; r < 10; ++r) {
+            quarterRoundAVX2(x[0], x[4], x[8], x[12], rot16, rot8);
+            quarterRoundAVX2(x[1], x[5], x[9], x[13], rot16, rot8);
+            quarterRoundAVX2(x[2], x[6], x[10], x[14], rot16, rot8);
+            quarterRoundAVX2(x[3], x[7], x[11], x[15], rot16, rot8);
+            quarterRoundAVX2(x[0], x[5], x[10], x[15], rot16, rot8);
+            quarterRoundAVX2(x[1], x[6], x[11], x[12], rot16, rot8);
+            quarterRoundAVX2(x[2], x[7], x[8], x[13], rot16, rot8);
+            quarterRoundAVX2(x[3], x[4], x[9], x[14], rot16, rot8);
+        }
+        for (int i = 0; i < 16; ++i) x[i] = _mm256_add_epi32(x[i], s[i]);
+        for (int g = 0; g < 16; g += 4) transpose4(x[g], x[g + 1], x[g + 2], x[g + 3]);
+
+        // x[4g + k] now holds words 4g..4g+3 of block k (low lane) and k + 4
+        // (high lane); pair the lanes back up into 32-byte halves of each block
+        for (int k = 0; k < 4; ++k) {
+            uint8_t* lo = out + 64 * k;
+            uint8_t* hi = out + 64 * (k + 4);
+            const uint8_t* inLo = in + 64 * k;
+            const uint8_t* inHi = in + 64 * (k + 4);
+            xor32(inLo, lo, _mm256_permute2x128_si256(x[k], x[4 + k], 0x20));
+            xor32(inLo + 32, lo + 32, _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x20));
+            xor32(inHi, hi, _mm256_permute2x128_si256(x[k], x[4 + k], 0x31));
+            xor32(inHi + 32, hi + 32, _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x31));
+        }
+        st[12] += 8;
+    }
+    xorBlocksSSE2(st, in, out, blocks);
+}
+#endif
+
+// --- NEON (4 blocks) ---
+
+#if defined(QUASAR_NEON)
+template <int N>
+static inline uint32x4_t rotlNEON(uint32x4_t x) {
+    return vsriq_n_u32(vshlq_n_u32(x, N), x, 32 - N);
+}
+
+static inline void quarterRoundNEON(uint32x4_t& a, uint32x4_t& b, uint32x4_t& c, uint32x4_t& d) {
+    a = vaddq_u32(a, b); d = veorq_u32(d, a);
+    d = vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(d))); // rotl 16
+    c = vaddq_u32(c, d); b = rotlNEON<12>(veorq_u32(b, c));
+    a = vaddq_u32(a, b); d = rotlNEON<8>(veorq_u32(d, a));
+    c = vaddq_u32(c, d); b = rotlNEON<7>(veorq_u32(b, c));
+}
+
+static void xorBlocksNEON(const uint32_t state[16], const uint8_t* in, uint8_t* out, size_t blocks) {
+    static const uint32_t kLaneOffsets[4] = {0, 1, 2, 3};
+    uint32_t st[16];
+    std::memcpy(st, state, sizeof(st));
+
+    for (; blocks >= 4; blocks -= 4, in += 256, out += 256) {
+        uint32x4_t s[16], x[16];
+        for (int i = 0; i < 16; ++i) s[i] = vdupq_n_u32(st[i]);
+        s[12] = vaddq_u32(s[12], vld1q_u32(kLaneOffsets));
+        for (int i = 0; i < 16; ++i) x[i] = s[i];
+
+        for (int r = 0; r < 10; ++r) {
+            quarterRoundNEON(x[0], x[4], x[8], x[12]);
+            quarterRoundNEON(x[1], x[5], x[9], x[13]);
+            quarterRoundNEON(x[2], x[6], x[10], x[14]);
+            quarterRoundNEON(x[3], x[7], x[11], x[15]);
+            quarterRoundNEON(x[0], x[5], x[10], x[15]);
+            quarterRoundNEON(x[1], x[6], x[11], x[12]);
+            quarterRoundNEON(x[2], x[7], x[8], x[13]);
+            quarterRoundNEON(x[3], x[4], x[9], x[14]);
+        }
+        for (int i = 0; i < 16; ++i) x[i] = vaddq_u32(x[i], s[i]);
+
+        for (int g = 0; g < 16; g += 4) {
+            // 4x4 transpose: rows[k] = words g..g+3 of block k
+            uint32x4x2_t t0 = vtrnq_u32(x[g], x[g + 1]);
+            uint32x4x2_t t1 = vtrnq_u32(x[g + 2], x[g + 3]);
+            uint32x4_t rows[4] = {
+                vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0])),
+                vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1])),
+                vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0])),
+                vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1])),
+            };
+            for (int k = 0; k < 4; ++k) {
+                const size_t off = 64 * k + 4 * g;
+                uint8x16_t v = vld1q_u8(in + off);
+                vst1q_u8(out + off, veorq_u8(v, vreinterpretq_u8_u32(rows[k])));
+            }
+        }
+        st[12] += 4;
+    }
+    xorBlocksScalar(st, in, out, blocks);
+}
+#endif
+
+// --- Dispatch ---
+
+const ChaChaKernels& chachaScalarKernels() {
+    static const ChaChaKernels k = {"scalar", xorBlocksScalar};
+    return k;
+}
+
+static const ChaChaKernels& selectKernels() {
+#if defined(QUASAR_X86)
+    if (cpuFeatures().avx2) {
+        static const ChaChaKernels k = {"avx2", xorBlocksAVX2};
+        return k;
+    }
+    if (cpuFeatures().sse2) {
+        static const ChaChaKernels k = {"sse2", xorBlocksSSE2};
+        return k;
+    }
+#endif
+#if defined(QUASAR_NEON)
+    if (cpuFeatures().neon) {
+        static const ChaChaKernels k = {"neon", xorBlocksNEON};
+        return k;
+    }
+#endif
+    return chachaScalarKernels();
+}
+
+const ChaChaKernels& chachaKernels() {
+    static const ChaChaKernels& k = selectKernels();
+    return k;
+}
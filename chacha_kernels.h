@@ -0,0 +1,26 @@
+#ifndef CHACHA_KERNELS_H
+#define CHACHA_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ChaCha20 keystream kernels used by chacha.cpp. The SIMD variants compute
+// 4 (SSE2/NEON) or 8 (AVX2) blocks side by side, one state word per vector
+// lane, and XOR the keystream a vector at a time. All variants produce the
+// same bytes as the scalar reference.
+struct ChaChaKernels {
+    const char* name;
+
+    // out = in ^ keystream for `blocks` whole 64-byte blocks, starting at the
+    // block counter in state[12] (which wraps mod 2^32). `in` and `out` may
+    // be the same buffer; `state` is not modified.
+    void (*xorBlocks)(const uint32_t state[16], const uint8_t* in, uint8_t* out, size_t blocks);
+};
+
+// Portable reference kernels
+const ChaChaKernels& chachaScalarKernels();
+
+// Best kernels for the running CPU (selected once via cpuFeatures())
+const ChaChaKernels& chachaKernels();
+
+#endif // CHACHA_KERNELS_H
@@ -0,0 +1,178 @@
+#include "coeff_codec.h"
+#include "varint.h"
+#include <bit>
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+constexpr uint8_t kEndOfBand = 0x00;
+constexpr uint8_t kLongRun = 0xE0;
+constexpr int kMaxShortRun = 6;
+
+void emitZeroRun(uint32_t run, std::vector<uint8_t>& symbols, BitPacker& raw) {
+    int k = std::bit_width(run) - 1;
+    symbols.push_back(static_cast<uint8_t>(kLongRun | k));
+    raw.write(run - (1u << k), k);
+}
+
+// Subbands [firstBand, firstBand + bandCount), clamped to the layout
+void bandRange(int width, int height, int levels, int firstBand, int bandCount, std::vector<Subband>& bands) {
+    subbandLayout(width, height, levels, bands);
+    int first = std::clamp(firstBand, 0, static_cast<int>(bands.size()));
+    int last = std::clamp(firstBand + bandCount, first, static_cast<int>(bands.size()));
+    bands.erase(bands.begin() + last, bands.end());
+    bands.erase(bands.begin(), bands.begin() + first);
+}
+
+// Number of subbands subbandLayout() returns
+int layoutSize(int width, int height, int levels) {
+    return 1 + 3 * std::clamp(levels, 1, std::max(1, maxWaveletLevels(width, height)));
+}
+
+} // namespace
+
+std::vector<uint8_t> CoefficientCodec::encode(const std::vector<int32_t>& coeffs, int width, int height, int levels) {
+    std::vector<uint8_t> out;
+    encode(coeffs, width, height, levels, out);
+    return out;
+}
+
+void CoefficientCodec::encode(const std::vector<int32_t>& coeffs, int width, int height, int levels,
+                              std::vector<uint8_t>& out) {
+    encodeBands(coeffs, width, height, levels, 0, layoutSize(width, height, levels), out);
+}
+
+void CoefficientCodec::reserve(size_t bandSize, size_t bandBytes) {
+    bands.reserve(1 + 3 * 16);      // 16-bit frame sizes allow at most 16 levels
+    symbols.reserve(bandSize + 1);  // At most one symbol per coefficient, plus end of band
+    coded.reserve(bandBytes);
+    raw.data.reserve(bandBytes);
+}
+
+bool CoefficientCodec::decode(std::span<const uint8_t> data, int width, int height, int levels, std::vector<int32_t>& coeffs) {
+    coeffs.resize(static_cast<size_t>(width) * height);
+    return decodeBands(data, width, height, levels, 0, layoutSize(width, height, levels), coeffs);
+}
+
+std::vector<uint8_t> CoefficientCodec::encodeBands(const std::vector<int32_t>& coeffs, int width, int height, int levels,
+                                                   int firstBand, int bandCount) {
+    std::vector<uint8_t> out;
+    encodeBands(coeffs, width, height, levels, firstBand, bandCount, out);
+    return out;
+}
+
+void CoefficientCodec::encodeBands(const std::vector<int32_t>& coeffs, int width, int height, int levels,
+                                   int firstBand, int bandCount, std::vector<uint8_t>& output) {
+    output.clear();
+    bandRange(width, height, levels, firstBand, bandCount, bands);
+
+    for (const Subband& band : bands) {
+        symbols.clear();
+        raw.clear();
+        uint32_t run = 0;
+        bool anyNonZero = false;
+
+        for (int r = 0; r < band.height; ++r) {
+            const int32_t* row = coeffs.data() + static_cast<size_t>(band.y + r) * width + band.x;
+            for (int c = 0; c < band.width; ++c) {
+                int32_t v = row[c];
+                if (v == 0) {
+                    run++;
+                    continue;
+                }
+                anyNonZero = true;
+                if (run > kMaxShortRun) {
+                    emitZeroRun(run, symbols, raw);
+                    run = 0;
+                }
+                // INT32_MIN's magnitude needs a 32nd class bit the symbol
+                // does not have: it is coded as -INT32_MAX
+                uint32_t mag = v < 0 ? static_cast<uint32_t>(-static_cast<int64_t>(std::max(v, -INT32_MAX)))
+                                     : static_cast<uint32_t>(v);
+                int cls = std::bit_width(mag);
+                symbols.push_back(static_cast<uint8_t>((run << 5) | cls));
+                raw.write(v < 0 ? 1 : 0, 1);
+                raw.write(mag, cls - 1);
+                run = 0;
+            }
+        }
+
+        if (!anyNonZero) {
+            // All-zero band: just an empty symbol stream
+            writeVarint(0, output);
+            continue;
+        }
+        if (run > 0) symbols.push_back(kEndOfBand);
+        raw.flush();
+
+        huffman.compress(symbols, coded);
+        writeVarint(coded.size(), output);
+        output.insert(output.end(), coded.begin(), coded.end());
+        writeVarint(raw.data.size(), output);
+        output.insert(output.end(), raw.data.begin(), raw.data.end());
+    }
+}
+
+bool CoefficientCodec::decodeBands(std::span<const uint8_t> data, int width, int height, int levels,
+                                   int firstBand, int bandCount, std::vector<int32_t>& coeffs) {
+    if (coeffs.size() != static_cast<size_t>(width) * height) return false;
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+
+    std::vector<Subband> range;
+    bandRange(width, height, levels, firstBand, bandCount, range);
+    for (const Subband& band : range) {
+        for (int r = 0; r < band.height; ++r) {
+            int32_t* row = coeffs.data() + static_cast<size_t>(band.y + r) * width + band.x;
+            std::fill(row, row + band.width, 0);
+        }
+        uint64_t codedSize = 0, rawSize = 0;
+        if (!readVarint(p, end, codedSize)) return false;
+        if (codedSize == 0) continue; // All-zero band
+        if (codedSize > static_cast<uint64_t>(end - p)) return false;
+
+        std::vector<uint8_t> decoded = huffman.decompress({p, static_cast<size_t>(codedSize)});
+        p += codedSize;
+
+        if (!readVarint(p, end, rawSize) || rawSize > static_cast<uint64_t>(end - p)) return false;
+        BitUnpacker raw(p, p + rawSize);
+        p += rawSize;
+
+        // Walk the band in raster order; `pos` counts coefficients placed so far
+        const uint64_t total = static_cast<uint64_t>(band.width) * band.height;
+        uint64_t pos = 0;
+        auto at = [&](uint64_t k) -> int32_t& {
+            return coeffs[static_cast<size_t>(band.y + k / band.width) * width + band.x + k % band.width];
+        };
+
+        for (size_t s = 0; s < decoded.size(); ++s) {
+            const uint8_t sym = decoded[s];
+            if (pos >= total) return false;
+            if (sym == kEndOfBand) {
+                // Only ever the last symbol of a band
+                if (s + 1 != decoded.size()) return false;
+                pos = total;
+                break;
+            }
+            int run = sym >> 5;
+            int cls = sym & 0x1F;
+            uint32_t bits = 0;
+            if (run == 7) {
+                if (!raw.read(cls, bits)) return false;
+                pos += (1ull << cls) + bits;
+                continue;
+            }
+            if (cls == 0) return false;
+            pos += run;
+            uint32_t sign = 0;
+            if (pos >= total || !raw.read(1, sign) || !raw.read(cls - 1, bits)) return false;
+            uint32_t mag = (1u << (cls - 1)) | bits;
+            at(pos++) = sign ? -static_cast<int32_t>(mag) : static_cast<int32_t>(mag);
+        }
+        // The encoder always fills the band exactly: a symbol stream that
+        // stops short is a damaged one, not a band of trailing zeros
+        if (pos != total) return false;
+    }
+    return p == end;  // Nothing may follow the last band
+}
@@ -0,0 +1,71 @@
+#ifndef COEFF_CODEC_H
+#define COEFF_CODEC_H
+
+#include <vector>
+#include <cstdint>
+#include <span>
+#include "bit_io.h"
+#include "huffman.h"
+#include "wavelet.h"
+
+/**
+ * Coefficient entropy coder.
+ *
+ * Codes quantized wavelet coefficients directly instead of their 4-byte
+ * serialization. Each subband (see subbandLayout) is scanned in raster order
+ * and turned into run/class symbols:
+ *
+ *   (run << 5) | cls   run (0..6) zeros, then a nonzero coefficient whose
+ *                      magnitude has bit length cls (1..31); followed by cls
+ *                      raw bits: sign, then the magnitude below its top bit
+ *   0xE0 | k           a zero run of 2^k + x coefficients; k raw bits of x
+ *   0x00               end of band: the rest of the subband is zero
+ *
+ * Symbols are Huffman coded with a table per subband, so each band gets its
+ * own run/magnitude statistics, and the raw bits are packed separately.
+ * Masked-out background collapses into a handful of long-run and end-of-band
+ * symbols, and an all-zero subband costs one byte.
+ *
+ * The encoder keeps its symbol and raw-bit buffers between calls: one codec
+ * encoding frame after frame into the same output vector allocates only
+ * until its buffers have grown to the largest frame.
+ */
+class CoefficientCodec {
+public:
+    // Encodes a width x height coefficient plane transformed with `levels`
+    // levels. Values are coded in [-INT32_MAX, INT32_MAX]; INT32_MIN is
+    // clamped to -INT32_MAX (quantizeCoefficients never produces it).
+    std::vector<uint8_t> encode(const std::vector<int32_t>& coeffs, int width, int height, int levels);
+    // Same, into `out` (replacing its contents, keeping its storage)
+    void encode(const std::vector<int32_t>& coeffs, int width, int height, int levels, std::vector<uint8_t>& out);
+
+    // Decodes into `coeffs` (resized to width * height). Returns false if the
+    // stream is truncated or malformed, or if bytes follow the last band.
+    bool decode(std::span<const uint8_t> data, int width, int height, int levels, std::vector<int32_t>& coeffs);
+
+    // Band-range variants for progressive layers: only subbands
+    // [firstBand, firstBand + bandCount) of subbandLayout() order are coded,
+    // and the stream decodes on its own. decodeBands writes into an existing
+    // width x height plane and leaves every other subband untouched; like
+    // decode, it rejects a stream with bytes past its last band.
+    std::vector<uint8_t> encodeBands(const std::vector<int32_t>& coeffs, int width, int height, int levels,
+                                     int firstBand, int bandCount);
+    void encodeBands(const std::vector<int32_t>& coeffs, int width, int height, int levels,
+                     int firstBand, int bandCount, std::vector<uint8_t>& out);
+    bool decodeBands(std::span<const uint8_t> data, int width, int height, int levels,
+                     int firstBand, int bandCount, std::vector<int32_t>& coeffs);
+
+    // Pre-sizes the encoder scratch for subbands of up to `bandSize`
+    // coefficients whose coded and raw streams take up to `bandBytes` bytes
+    void reserve(size_t bandSize, size_t bandBytes);
+
+private:
+    // Encoder scratch, reused from band to band and call to call
+    std::vector<Subband> bands;
+    std::vector<uint8_t> symbols;
+    std::vector<uint8_t> coded;
+    BitPacker raw;
+    HuffmanCodec huffman;
+};
+
+#endif // COEFF_CODEC_H
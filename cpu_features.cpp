@@ -0,0 +1,57 @@
+#include "cpu_features.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(QUASAR_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+CpuFeatures detect() {
+    CpuFeatures f;
+
+    const char* noSimd = std::getenv("QUASAR_NO_SIMD");
+    if (noSimd && std::strcmp(noSimd, "0") != 0) return f;
+
+#if defined(QUASAR_X86)
+#if defined(_MSC_VER)
+    // CPUID.7.0:EBX[5] = AVX2, and the OS must save YMM state (XCR0 bits 1,2)
+    int regs[4];
+    __cpuid(regs, 1);
+    f.sse2 = (regs[3] & (1 << 26)) != 0;
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    bool avx = (regs[2] & (1 << 28)) != 0;
+    __cpuidex(regs, 7, 0);
+    f.avx2 = osxsave && avx && (regs[1] & (1 << 5)) && ((_xgetbv(0) & 0x6) == 0x6);
+#else
+    __builtin_cpu_init();
+    f.sse2 = __builtin_cpu_supports("sse2");
+    f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+#endif
+
+#if defined(QUASAR_NEON)
+#if defined(__linux__)
+    f.neon = (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+    // Advanced SIMD is mandatory on ARMv8-A
+    f.neon = true;
+#endif
+#endif
+
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
@@ -0,0 +1,33 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Runtime CPU capability detection, so one binary can pick SIMD kernels
+// on the machine it actually runs on instead of at compile time.
+struct CpuFeatures {
+    bool sse2 = false;   // x86 SSE2 (always present on x86-64)
+    bool avx2 = false;   // x86-64 AVX2
+    bool neon = false;   // AArch64 Advanced SIMD
+};
+
+// Detected once on first use. Setting QUASAR_NO_SIMD=1 in the environment
+// reports no SIMD support (useful for A/B benchmarks and debugging).
+const CpuFeatures& cpuFeatures();
+
+// GCC/Clang attributes that enable SSE2/AVX2 code generation for a single
+// function without requiring -msse2/-mavx2 for the whole translation unit.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_AMD64)
+#define QUASAR_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define QUASAR_TARGET_SSE2 __attribute__((target("sse2")))
+#define QUASAR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define QUASAR_TARGET_SSE2
+#define QUASAR_TARGET_AVX2
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define QUASAR_NEON 1
+#endif
+
+#endif // CPU_FEATURES_H
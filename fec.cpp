@@ -0,0 +1,89 @@
+#include "fec.h"
+#include "gf256_kernels.h"
+#include <vector>
+#include <cstring>
+#include <utility>
+
+uint8_t fecCoefficient(int k, int row, int col) {
+    // Rows are x = k + row, columns y = col; the sets are disjoint, so x ^ y != 0
+    return gfInv(static_cast<uint8_t>((k + row) ^ col));
+}
+
+void fecEncode(const uint8_t* const data[], const size_t sizes[], int k,
+               uint8_t* const parity[], int m, size_t shard) {
+    const Gf256Kernels& gf = gf256Kernels();
+    for (int r = 0; r < m; ++r) {
+        std::memset(parity[r], 0, shard);
+        for (int j = 0; j < k; ++j) {
+            gf.mulAdd(parity[r], data[j], fecCoefficient(k, r, j), sizes[j]);
+        }
+    }
+}
+
+// Inverts the n x n matrix `a` in place (Gauss-Jordan over GF(256))
+static bool invert(std::vector<uint8_t>& a, int n) {
+    std::vector<uint8_t> inv(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; ++i) inv[i * n + i] = 1;
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        while (pivot < n && a[pivot * n + col] == 0) ++pivot;
+        if (pivot == n) return false;
+        if (pivot != col) {
+            for (int j = 0; j < n; ++j) {
+                std::swap(a[pivot * n + j], a[col * n + j]);
+                std::swap(inv[pivot * n + j], inv[col * n + j]);
+            }
+        }
+        uint8_t scale = gfInv(a[col * n + col]);
+        for (int j = 0; j < n; ++j) {
+            a[col * n + j] = gfMul(a[col * n + j], scale);
+            inv[col * n + j] = gfMul(inv[col * n + j], scale);
+        }
+        for (int row = 0; row < n; ++row) {
+            uint8_t f = a[row * n + col];
+            if (row == col || f == 0) continue;
+            for (int j = 0; j < n; ++j) {
+                a[row * n + j] ^= gfMul(f, a[col * n + j]);
+                inv[row * n + j] ^= gfMul(f, inv[col * n + j]);
+            }
+        }
+    }
+    a.swap(inv);
+    return true;
+}
+
+bool fecRecover(uint8_t* const data[], const bool dataPresent[], int k,
+                uint8_t* const parity[], const bool parityPresent[], int m, size_t shard) {
+    std::vector<int> missing, rows;
+    for (int j = 0; j < k; ++j) {
+        if (!dataPresent[j]) missing.push_back(j);
+    }
+    if (missing.empty()) return true;
+    for (int r = 0; r < m && rows.size() < missing.size(); ++r) {
+        if (parityPresent[r]) rows.push_back(r);
+    }
+    if (rows.size() < missing.size()) return false;
+
+    // Strip the known data out of each parity shard, leaving
+    // s_r = sum over missing j of C(r, j) * data[j]
+    const Gf256Kernels& gf = gf256Kernels();
+    for (int r : rows) {
+        for (int j = 0; j < k; ++j) {
+            if (dataPresent[j]) gf.mulAdd(parity[r], data[j], fecCoefficient(k, r, j), shard);
+        }
+    }
+
+    // Solve the e x e Cauchy system for the missing shards
+    const int e = static_cast<int>(missing.size());
+    std::vector<uint8_t> a(static_cast<size_t>(e) * e);
+    for (int i = 0; i < e; ++i) {
+        for (int l = 0; l < e; ++l) a[i * e + l] = fecCoefficient(k, rows[i], missing[l]);
+    }
+    if (!invert(a, e)) return false;
+    for (int l = 0; l < e; ++l) {
+        uint8_t* out = data[missing[l]];
+        std::memset(out, 0, shard);
+        for (int i = 0; i < e; ++i) gf.mulAdd(out, parity[rows[i]], a[l * e + i], shard);
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef FEC_H
+#define FEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Systematic Reed-Solomon erasure code over GF(256).
+ *
+ * A group of k data shards gets m parity shards, parity[r] = sum_j
+ * C(r, j) * data[j], with the Cauchy matrix C(r, j) = 1 / ((k + r) ^ j).
+ * Every square submatrix of a Cauchy matrix is invertible, so any k of the
+ * k + m shards recover the group. Requires k + m <= 256.
+ *
+ * Shards are `shard` bytes; a shorter data shard (the last chunk of a frame)
+ * is treated as zero padded.
+ */
+uint8_t fecCoefficient(int k, int row, int col);
+
+// Computes all m parity shards of a group
+void fecEncode(const uint8_t* const data[], const size_t sizes[], int k,
+               uint8_t* const parity[], int m, size_t shard);
+
+// Rebuilds the missing data shards in place. Present data shards must be
+// full `shard` bytes (zero padded); received parity shards are used as
+// scratch and left clobbered. Returns false when fewer than k shards arrived.
+bool fecRecover(uint8_t* const data[], const bool dataPresent[], int k,
+                uint8_t* const parity[], const bool parityPresent[], int m, size_t shard);
+
+#endif // FEC_H
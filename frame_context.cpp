@@ -0,0 +1,28 @@
+#include "frame_context.h"
+#include "aead.h"
+#include <algorithm>
+
+void FrameContext::reserve(int width, int height, int levels, size_t payloadBytes) {
+    const size_t pixels = static_cast<size_t>(std::max(width, 0)) * std::max(height, 0);
+    if (pixels == 0) return;
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(width, height)));
+    if (payloadBytes == 0) payloadBytes = pixels;
+
+    img.data.reserve(pixels);
+    targets.reserve(8);
+    coeffs.reserve(pixels);
+    payload.reserve(payloadBytes);
+    archive.reserve(sizeof(QuasarHeader) + payloadBytes + ChaCha20Poly1305::kTagSize);
+
+    // Running the passes once on a blank frame sizes the transform scratch,
+    // the subband layout and the mask row offsets exactly
+    GrayImage blank(width, height);
+    std::vector<ROI> centre = {{static_cast<uint16_t>(width / 2), static_cast<uint16_t>(height / 2), 1}};
+    transform2D(blank, levels, wavelet);
+    applySubbandSaliency(blank, centre, levels, 0.0f, 0, 0, wavelet);
+    wavelet.spans.reserve(8);
+    size_t largest = 0;
+    for (const Subband& band : wavelet.bands) largest = std::max(largest, static_cast<size_t>(band.width) * band.height);
+    for (SpanMask& mask : wavelet.masks) mask.spans.reserve(static_cast<size_t>(mask.height) * 8);
+    codec.reserve(largest, std::min(largest, payloadBytes));
+}
@@ -0,0 +1,39 @@
+#ifndef FRAME_CONTEXT_H
+#define FRAME_CONTEXT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "quasar_format.h"
+#include "wavelet.h"
+#include "coeff_codec.h"
+
+/**
+ * Working set of one frame in the streaming encoder.
+ *
+ * Every buffer a frame passes through between capture and its archive lives
+ * here: the image, the coefficients, the coded payload, the archive, and the
+ * scratch of the transform, the ROI masks and the entropy coder. A context
+ * is reused for frame after frame and its vectors are only cleared or
+ * resized, never released, so once they have grown to the stream's
+ * resolution (and its largest payload) a frame is encoded without a single
+ * heap allocation. reserve() does the growing before the first frame.
+ */
+struct FrameContext {
+    GrayImage img{0, 0};
+    std::vector<ROI> targets;
+    std::vector<int32_t> coeffs;
+    std::vector<uint8_t> payload;     // Coded coefficients
+    std::vector<uint8_t> archive;     // Header, payload and tag
+
+    WaveletScratch wavelet;
+    CoefficientCodec codec;
+
+    // Sizes every buffer for width x height frames with `levels` wavelet
+    // levels. Coded sizes depend on the content: the payload buffers are
+    // sized for `payloadBytes` (0: one byte per pixel, more than an
+    // ROI-masked frame codes to) and grow if a frame needs more.
+    void reserve(int width, int height, int levels, size_t payloadBytes = 0);
+};
+
+#endif // FRAME_CONTEXT_H
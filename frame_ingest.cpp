@@ -0,0 +1,277 @@
+#include "frame_ingest.h"
+#include "pixel_kernels.h"
+#include "spsc_ring.h"
+#include <iostream>
+#include <cstring>
+#include <new>
+#include <cerrno>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+int maxValue(const FrameDescriptor& d) {
+    return d.max_value ? d.max_value : 255;
+}
+
+size_t sampleBytes(uint16_t width, uint16_t height, int maxValue) {
+    return static_cast<size_t>(width) * height * (maxValue > 255 ? 2 : 1);
+}
+
+bool validDescriptor(const FrameDescriptor& d, size_t room) {
+    return std::memcmp(d.magic, "QSRF", 4) == 0 && d.width > 0 && d.height > 0 &&
+           sampleBytes(d.width, d.height, maxValue(d)) <= room;
+}
+
+void convertFrame(const FrameDescriptor& d, const uint8_t* samples, GrayImage& img) {
+    // Reuses img.data's storage when the size does not change
+    img.width = d.width;
+    img.height = d.height;
+    img.maxVal = maxValue(d);
+    img.data.resize(static_cast<size_t>(d.width) * d.height);
+    const PixelKernels& k = pixelKernels();
+    (img.maxVal > 255 ? k.u16leToFloat : k.u8ToFloat)(samples, img.data.data(), img.data.size());
+}
+
+// Counts the frames missing between the previous sequence number and this one
+void noteSequence(uint32_t sequence, uint32_t& expected, bool& first, uint64_t& skipped) {
+    if (!first) skipped += sequence - expected;
+    first = false;
+    expected = sequence + 1;
+}
+
+std::string shmName(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+} // namespace
+
+// --- FrameRingWriter ---
+
+bool FrameRingWriter::create(const std::string& target, uint32_t slots, size_t maxFrameBytes) {
+    close();
+#ifdef _WIN32
+    (void)target; (void)slots; (void)maxFrameBytes;
+    std::cerr << "Shared-memory frame rings are not supported on this platform" << std::endl;
+    return false;
+#else
+    if (slots == 0) return false;
+    name = shmName(target);
+    const size_t slotSize = (sizeof(FrameDescriptor) + maxFrameBytes + 63) & ~size_t(63);
+    length = sizeof(FrameRingHeader) + slots * slotSize;
+
+    // A ring left behind by a crashed run is replaced, not reused
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        std::cerr << "Cannot create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    void* p = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    ring = new (p) FrameRingHeader();
+    ring->version = kFrameRingVersion;
+    ring->slot_count = slots;
+    ring->slot_size = static_cast<uint32_t>(slotSize);
+    ring->producer_pid = static_cast<int32_t>(getpid());
+    // The magic goes in last: a consumer that sees it sees the whole header
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(ring->magic, "QSRR", 4);
+    writeIndex = cachedRead = 0;
+    sequence = 0;
+    return true;
+#endif
+}
+
+uint8_t* FrameRingWriter::claim(uint16_t width, uint16_t height, uint16_t maxValue, bool wait) {
+    if (!ring) return nullptr;
+    const uint32_t seq = sequence++;
+    const int range = maxValue ? maxValue : 255;
+    if (width == 0 || height == 0 || sizeof(FrameDescriptor) + sampleBytes(width, height, range) > ring->slot_size) {
+        return nullptr;
+    }
+    // Full: every slot holds a frame the consumer has not finished with
+    for (int spins = 0; writeIndex - cachedRead == ring->slot_count; ++spins) {
+        cachedRead = ring->read_index.load(std::memory_order_acquire);
+        if (writeIndex - cachedRead < ring->slot_count) break;
+        if (!wait) return nullptr;
+        ringBackoff(spins);
+    }
+
+    uint8_t* slot = reinterpret_cast<uint8_t*>(ring + 1) + (writeIndex % ring->slot_count) * ring->slot_size;
+    FrameDescriptor d = {};
+    std::memcpy(d.magic, "QSRF", 4);
+    d.sequence = seq;
+    d.width = width;
+    d.height = height;
+    d.max_value = maxValue;
+    std::memcpy(slot, &d, sizeof(d));
+    return slot + sizeof(d);
+}
+
+void FrameRingWriter::publish() {
+    if (ring) ring->write_index.store(++writeIndex, std::memory_order_release);
+}
+
+void FrameRingWriter::close() {
+#ifndef _WIN32
+    if (ring) {
+        ring->closed.store(1, std::memory_order_release);
+        munmap(ring, length);
+        shm_unlink(name.c_str());
+    }
+#endif
+    ring = nullptr;
+    length = 0;
+}
+
+// --- FrameRingReader ---
+
+bool FrameRingReader::open(const std::string& target) {
+    close();
+#ifdef _WIN32
+    (void)target;
+    std::cerr << "Shared-memory frame rings are not supported on this platform" << std::endl;
+    return false;
+#else
+    const std::string name = shmName(target);
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        std::cerr << "Cannot open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(FrameRingHeader)) {
+        p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << name << std::endl;
+        return false;
+    }
+    ring = static_cast<FrameRingHeader*>(p);
+    length = static_cast<size_t>(st.st_size);
+
+    const bool valid = std::memcmp(ring->magic, "QSRR", 4) == 0 && ring->version == kFrameRingVersion &&
+                       ring->slot_count > 0 && ring->slot_size >= sizeof(FrameDescriptor) && ring->slot_size % 64 == 0 &&
+                       (length - sizeof(FrameRingHeader)) / ring->slot_size >= ring->slot_count;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid) {
+        std::cerr << name << " is not a frame ring" << std::endl;
+        close();
+        return false;
+    }
+    // A restarted consumer carries on where the last one stopped
+    readIndex = cachedWrite = ring->read_index.load(std::memory_order_acquire);
+    first = true;
+    skipped = 0;
+    stopping = false;
+    return true;
+#endif
+}
+
+void FrameRingReader::close() {
+#ifndef _WIN32
+    if (ring) munmap(ring, length);
+#endif
+    ring = nullptr;
+    length = 0;
+}
+
+bool FrameRingReader::producerAlive() const {
+#ifdef _WIN32
+    return true;
+#else
+    return kill(ring->producer_pid, 0) == 0 || errno == EPERM;
+#endif
+}
+
+bool FrameRingReader::next(GrayImage& img) {
+    if (!ring) return false;
+    for (int spins = 0; readIndex == cachedWrite; ++spins) {
+        cachedWrite = ring->write_index.load(std::memory_order_acquire);
+        if (readIndex != cachedWrite || stopping) break;
+        if (ring->closed.load(std::memory_order_acquire)) {
+            // Frames published before the close are still drained
+            cachedWrite = ring->write_index.load(std::memory_order_acquire);
+            if (readIndex == cachedWrite) return false;
+            break;
+        }
+        // An idle producer is checked on now and then, a dead one ends the stream
+        if (spins == 4096) {
+            if (!producerAlive()) {
+                std::cerr << "[Ingest] Frame producer " << ring->producer_pid << " is gone" << std::endl;
+                return false;
+            }
+            spins = 256;
+        }
+        ringBackoff(spins);
+    }
+    if (stopping) return false;
+
+    const uint8_t* slot = reinterpret_cast<const uint8_t*>(ring + 1) + (readIndex % ring->slot_count) * ring->slot_size;
+    FrameDescriptor d;
+    std::memcpy(&d, slot, sizeof(d));
+    if (!validDescriptor(d, ring->slot_size - sizeof(d))) {
+        std::cerr << "[Ingest] Malformed frame in slot " << readIndex % ring->slot_count << std::endl;
+        return false;
+    }
+    noteSequence(d.sequence, expected, first, skipped);
+    convertFrame(d, slot + sizeof(d), img);
+    // The slot goes back to the producer only once its samples are copied out
+    ring->read_index.store(++readIndex, std::memory_order_release);
+    return true;
+}
+
+// --- RawFrameReader ---
+
+bool RawFrameReader::open(const std::string& path) {
+    close();
+    file = path == "-" ? stdin : std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    first = true;
+    skipped = 0;
+    return true;
+}
+
+void RawFrameReader::close() {
+    if (file && file != stdin) std::fclose(file);
+    file = nullptr;
+}
+
+bool RawFrameReader::next(GrayImage& img) {
+    if (!file) return false;
+    FrameDescriptor d;
+    const size_t got = std::fread(&d, 1, sizeof(d), file);
+    if (got == 0 && std::feof(file)) return false;  // Writer closed between frames
+    if (got != sizeof(d) || !validDescriptor(d, SIZE_MAX)) {
+        std::cerr << "[Ingest] Malformed frame descriptor" << std::endl;
+        return false;
+    }
+    buffer.resize(sampleBytes(d.width, d.height, maxValue(d)));
+    if (std::fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        std::cerr << "[Ingest] Truncated frame " << d.sequence << std::endl;
+        return false;
+    }
+    noteSequence(d.sequence, expected, first, skipped);
+    convertFrame(d, buffer.data(), img);
+    return true;
+}
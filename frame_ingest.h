@@ -0,0 +1,164 @@
+#ifndef FRAME_INGEST_H
+#define FRAME_INGEST_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include "wavelet.h"
+
+// Raw frame input for continuous capture: a camera process hands frames to a
+// long-running `quasar --stream` without writing them to disk.
+//
+// Every frame is a FrameDescriptor followed by width x height samples, row
+// by row: one byte each when max_value <= 255, otherwise two bytes,
+// little-endian (the layout of an 8-bit or Y16 camera buffer). Frames travel
+// through a shared-memory ring (FrameRingWriter -> FrameRingReader) or, back
+// to back, through a pipe (RawFrameReader).
+
+#ifdef _MSC_VER
+#pragma pack(push, 1)
+#endif
+
+struct
+#ifndef _MSC_VER
+__attribute__((packed))
+#endif
+FrameDescriptor {
+    char magic[4];          // 'Q', 'S', 'R', 'F'
+    uint32_t sequence;      // Capture counter; a gap is a frame the producer dropped
+    uint16_t width;
+    uint16_t height;
+    uint16_t max_value;     // Largest sample value (0 = 255)
+    uint16_t reserved;
+};
+
+#ifdef _MSC_VER
+#pragma pack(pop)
+#endif
+
+constexpr uint32_t kFrameRingVersion = 1;
+
+// Start of the shared-memory object. The slots follow it, slot i at offset
+// sizeof(FrameRingHeader) + i * slot_size; each holds one descriptor and its
+// samples. The indices count frames and only grow: slot = index % slot_count.
+struct FrameRingHeader {
+    char magic[4];                  // 'Q', 'S', 'R', 'R'
+    uint32_t version;               // kFrameRingVersion
+    uint32_t slot_count;
+    uint32_t slot_size;             // Bytes per slot, a multiple of 64
+    int32_t producer_pid;           // Lets the consumer notice a producer that died
+    std::atomic<uint32_t> closed;   // Set by the producer after its last frame
+    alignas(64) std::atomic<uint64_t> write_index;  // Frames published (producer)
+    alignas(64) std::atomic<uint64_t> read_index;   // Frames consumed (consumer)
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring indices must be address-free atomics");
+
+/**
+ * Producer side of the shared-memory ring, for the capture process.
+ *
+ * Frames are written straight into a slot: claim() returns the slot's sample
+ * area, the camera (or a copy) fills it, publish() hands it to the consumer.
+ * Single producer, single consumer, no locks; a slot is never touched by
+ * both sides at once.
+ */
+class FrameRingWriter {
+public:
+    FrameRingWriter() = default;
+    ~FrameRingWriter() { close(); }
+
+    FrameRingWriter(const FrameRingWriter&) = delete;
+    FrameRingWriter& operator=(const FrameRingWriter&) = delete;
+
+    // Creates the shared-memory object `name` (e.g. "/quasar_cam") with
+    // `slots` slots of up to `maxFrameBytes` sample bytes each
+    bool create(const std::string& name, uint32_t slots, size_t maxFrameBytes);
+
+    // Next slot's sample area for a width x height frame, or nullptr if the
+    // frame does not fit a slot or, with wait = false, every slot is in use.
+    // Either way the frame's sequence number is used up.
+    uint8_t* claim(uint16_t width, uint16_t height, uint16_t maxValue = 255, bool wait = true);
+    // Makes the claimed frame visible to the consumer
+    void publish();
+
+    // Marks the end of the stream and unmaps; the object is unlinked, the
+    // consumer keeps its own mapping and drains what is left
+    void close();
+
+private:
+    FrameRingHeader* ring = nullptr;
+    size_t length = 0;
+    std::string name;
+    uint64_t writeIndex = 0;
+    uint64_t cachedRead = 0;
+    uint32_t sequence = 0;
+};
+
+/**
+ * Consumer side of the shared-memory ring: a FrameSource for the streaming
+ * encoder. Samples are converted from the slot straight into the image.
+ */
+class FrameRingReader {
+public:
+    FrameRingReader() = default;
+    ~FrameRingReader() { close(); }
+
+    FrameRingReader(const FrameRingReader&) = delete;
+    FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+    bool open(const std::string& name);
+    void close();
+
+    // Waits for the next frame. False once the producer has closed (or died)
+    // and the ring is drained, after stop(), or on a malformed slot.
+    bool next(GrayImage& img);
+    // Ends a waiting next(); safe to call from a signal handler
+    void stop() { stopping = true; }
+
+    // Frames the producer skipped, from gaps in the sequence numbers
+    uint64_t dropped() const { return skipped; }
+
+private:
+    bool producerAlive() const;
+
+    FrameRingHeader* ring = nullptr;
+    size_t length = 0;
+    uint64_t readIndex = 0;
+    uint64_t cachedWrite = 0;
+    uint32_t expected = 0;
+    bool first = true;
+    uint64_t skipped = 0;
+    std::atomic<bool> stopping{false};
+};
+
+/**
+ * Frames written back to back to a pipe (or a file): descriptor, samples,
+ * descriptor, ... Ends cleanly when the writer closes between frames.
+ */
+class RawFrameReader {
+public:
+    RawFrameReader() = default;
+    ~RawFrameReader() { close(); }
+
+    RawFrameReader(const RawFrameReader&) = delete;
+    RawFrameReader& operator=(const RawFrameReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // False at the end of the stream or on a malformed / truncated frame
+    bool next(GrayImage& img);
+    uint64_t dropped() const { return skipped; }
+
+private:
+    std::FILE* file = nullptr;
+    std::vector<uint8_t> buffer;  // One frame's samples, reused
+    uint32_t expected = 0;
+    bool first = true;
+    uint64_t skipped = 0;
+};
+
+#endif // FRAME_INGEST_H
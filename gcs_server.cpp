@@ -0,0 +1,84 @@
+#include "gcs_server.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+struct GcsServer::Worker {
+    explicit Worker(size_t depth) : frames(depth), inbox(depth), spare(depth) {
+        for (ReceivedFrame& f : frames) spare.push(&f);
+    }
+
+    std::vector<ReceivedFrame> frames;  // Buffers cycling between the two rings
+    SpscRing<ReceivedFrame*> inbox;     // Receiver -> worker
+    SpscRing<ReceivedFrame*> spare;     // Worker -> receiver, once handled
+    std::thread thread;
+};
+
+GcsServer::GcsServer(unsigned worker_threads, size_t queue_depth, size_t max_in_flight)
+    : rx(max_in_flight) {
+    if (worker_threads == 0) worker_threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned i = 0; i < worker_threads; ++i) workers.push_back(std::make_unique<Worker>(std::max<size_t>(1, queue_depth)));
+}
+
+GcsServer::~GcsServer() {
+    stopping = true;
+    for (auto& w : workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+unsigned GcsServer::worker_for(const Peer& peer) const {
+    // Fibonacci hashing: drones on one host differ only in the low port bits
+    return static_cast<unsigned>(((peer.key() * 0x9E3779B97F4A7C15ull) >> 32) % workers.size());
+}
+
+bool GcsServer::run(int port, const Handler& handler) {
+    if (!rx.bind_port(port)) return false;
+    stopping = false;
+
+    std::atomic<bool> draining{false};
+    for (unsigned i = 0; i < workers.size(); ++i) {
+        Worker& w = *workers[i];
+        w.thread = std::thread([&, i] {
+            ReceivedFrame* f;
+            for (int spins = 0;; ++spins) {
+                // Read before popping: once draining is set every push is visible
+                const bool last = draining;
+                if (w.inbox.pop(f)) {
+                    handler(i, *f);
+                    w.spare.push(f);  // Never full: it holds at most every buffer
+                    spins = 0;
+                } else if (last) {
+                    return;
+                } else {
+                    // Idle workers nap longer; decode latency is in milliseconds anyway
+                    ringBackoff(spins, std::chrono::microseconds(200));
+                }
+            }
+        });
+    }
+
+    std::vector<uint8_t> frame;
+    Peer from;
+    while (!stopping) {
+        if (!rx.receive(port, frame, from, std::chrono::milliseconds(250))) continue;
+
+        Worker& w = *workers[worker_for(from)];
+        ReceivedFrame* slot;
+        if (!w.spare.pop(slot)) {
+            counters.frames_dropped_busy++;
+            continue;
+        }
+        counters.frames_dispatched++;
+        counters.link = rx.stats();
+        slot->peer = from;
+        slot->data.swap(frame);  // The slot's old buffer becomes the next receive buffer
+        slot->stats = counters;
+        w.inbox.push(slot);
+    }
+
+    // Buffers already queued still get handled before run() returns
+    draining = true;
+    for (auto& w : workers) w->thread.join();
+    return true;
+}
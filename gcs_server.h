@@ -0,0 +1,75 @@
+#ifndef GCS_SERVER_H
+#define GCS_SERVER_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "udp_link.h"
+#include "spsc_ring.h"
+
+// Server-side counters, as of the moment a frame was handed out
+struct GcsStats {
+    RxStats link;
+    uint64_t frames_dispatched = 0;    // Completed frames handed to a worker
+    uint64_t frames_dropped_busy = 0;  // Completed frames dropped: the drone's worker was backlogged
+};
+
+// One completed frame and the drone it came from
+struct ReceivedFrame {
+    Peer peer;
+    std::vector<uint8_t> data;
+    GcsStats stats;
+};
+
+/**
+ * Multi-drone ground station receiver.
+ *
+ * The thread calling run() does nothing but receive: it drains the socket,
+ * reassembles frames keyed by (sender, frame_id) and passes each completed
+ * frame to a worker, which runs the handler (decrypt, decode, save). A slow
+ * decode therefore never stalls the socket, and a swarm's frames are decoded
+ * on several cores at once.
+ *
+ * Every drone (sender address) is pinned to one worker, so its frames reach
+ * the handler in arrival order and per-drone state such as a progressive
+ * decoder can be kept per worker without locks. Frames travel through SPSC
+ * rings in preallocated buffers that are swapped, not copied. If a worker
+ * falls `queue_depth` frames behind, further frames for its drones are
+ * dropped and counted rather than blocking reception.
+ */
+class GcsServer {
+public:
+    using Handler = std::function<void(unsigned worker, ReceivedFrame& frame)>;
+
+    // workers = 0: one per hardware thread beyond the receiving one (at least 1)
+    explicit GcsServer(unsigned workers = 0, size_t queue_depth = 32, size_t max_in_flight = 64);
+    ~GcsServer();
+
+    GcsServer(const GcsServer&) = delete;
+    GcsServer& operator=(const GcsServer&) = delete;
+
+    unsigned worker_count() const { return static_cast<unsigned>(workers.size()); }
+
+    // Worker that handles frames from `peer`
+    unsigned worker_for(const Peer& peer) const;
+
+    // Receives on `port` until stop(); returns once every queued frame has
+    // been handled. False if the port cannot be bound.
+    bool run(int port, const Handler& handler);
+
+    // May be called from any thread, including a handler
+    void stop() { stopping = true; }
+
+private:
+    struct Worker;
+
+    QuasarRx rx;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopping{false};
+    GcsStats counters;
+};
+
+#endif // GCS_SERVER_H
@@ -0,0 +1,142 @@
+#include "gf256_kernels.h"
+#include "cpu_features.h"
+#include <array>
+
+#if defined(QUASAR_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON)
+#include <arm_neon.h>
+#endif
+
+// --- Field ---
+
+struct GfTables {
+    std::array<uint8_t, 512> exp;  // Doubled so exp[log a + log b] needs no modulo
+    std::array<uint8_t, 256> log;
+    GfTables() {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i) {
+            exp[i] = exp[i + 255] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) x ^= 0x11d;
+        }
+        exp[510] = exp[511] = exp[0];
+        log[0] = 0;
+    }
+};
+
+static const GfTables& tables() {
+    static const GfTables t;
+    return t;
+}
+
+uint8_t gfMul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    const GfTables& t = tables();
+    return t.exp[t.log[a] + t.log[b]];
+}
+
+uint8_t gfInv(uint8_t a) {
+    const GfTables& t = tables();
+    return t.exp[255 - t.log[a]];
+}
+
+// c * x = c * (x & 15) ^ c * (x & 0xf0): two 16-entry lookups per byte
+static void nibbleTables(uint8_t c, uint8_t lo[16], uint8_t hi[16]) {
+    for (int i = 0; i < 16; ++i) {
+        lo[i] = gfMul(c, static_cast<uint8_t>(i));
+        hi[i] = gfMul(c, static_cast<uint8_t>(i << 4));
+    }
+}
+
+// --- Scalar reference ---
+
+static void mulAddTail(uint8_t* dst, const uint8_t* src, size_t n, const uint8_t lo[16], const uint8_t hi[16]) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] ^= lo[src[i] & 15] ^ hi[src[i] >> 4];
+    }
+}
+
+static void mulAddScalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+    if (c == 0) return;
+    uint8_t lo[16], hi[16];
+    nibbleTables(c, lo, hi);
+    mulAddTail(dst, src, n, lo, hi);
+}
+
+// --- AVX2 ---
+
+#if defined(QUASAR_X86)
+// vpshufb looks up within each 128-bit lane, so both lanes get a copy of the
+// tables
+QUASAR_TARGET_AVX2
+static void mulAddAVX2(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+    if (c == 0) return;
+    uint8_t lo[16], hi[16];
+    nibbleTables(c, lo, hi);
+    const __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo)));
+    const __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hi)));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i pl = _mm256_shuffle_epi8(tlo, _mm256_and_si256(s, mask));
+        __m256i ph = _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi16(s, 4), mask));
+        d = _mm256_xor_si256(d, _mm256_xor_si256(pl, ph));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), d);
+    }
+    mulAddTail(dst + i, src + i, n - i, lo, hi);
+}
+#endif
+
+// --- NEON ---
+
+#if defined(QUASAR_NEON)
+static void mulAddNEON(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+    if (c == 0) return;
+    uint8_t lo[16], hi[16];
+    nibbleTables(c, lo, hi);
+    const uint8x16_t tlo = vld1q_u8(lo);
+    const uint8x16_t thi = vld1q_u8(hi);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t p = veorq_u8(vqtbl1q_u8(tlo, vandq_u8(s, mask)), vqtbl1q_u8(thi, vshrq_n_u8(s, 4)));
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), p));
+    }
+    mulAddTail(dst + i, src + i, n - i, lo, hi);
+}
+#endif
+
+// --- Dispatch ---
+
+const Gf256Kernels& gf256ScalarKernels() {
+    static const Gf256Kernels k = {"scalar", mulAddScalar};
+    return k;
+}
+
+static const Gf256Kernels& selectKernels() {
+#if defined(QUASAR_X86)
+    if (cpuFeatures().avx2) {
+        static const Gf256Kernels k = {"avx2", mulAddAVX2};
+        return k;
+    }
+#endif
+#if defined(QUASAR_NEON)
+    if (cpuFeatures().neon) {
+        static const Gf256Kernels k = {"neon", mulAddNEON};
+        return k;
+    }
+#endif
+    return gf256ScalarKernels();
+}
+
+const Gf256Kernels& gf256Kernels() {
+    static const Gf256Kernels& k = selectKernels();
+    return k;
+}
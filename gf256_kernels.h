@@ -0,0 +1,28 @@
+#ifndef GF256_KERNELS_H
+#define GF256_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Arithmetic in GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11d),
+// the field used by the FEC layer. Addition is XOR.
+uint8_t gfMul(uint8_t a, uint8_t b);
+uint8_t gfInv(uint8_t a);  // a != 0
+
+// Bulk region kernels. Every implementation multiplies through the same pair
+// of 16-entry nibble tables (c * low nibble, c * high nibble), so the SIMD
+// versions are a table shuffle per 16/32 bytes and all are bit-identical.
+struct Gf256Kernels {
+    const char* name;
+
+    // dst[i] ^= c * src[i]
+    void (*mulAdd)(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n);
+};
+
+// Portable reference kernels
+const Gf256Kernels& gf256ScalarKernels();
+
+// Best kernels for the running CPU (selected once via cpuFeatures())
+const Gf256Kernels& gf256Kernels();
+
+#endif // GF256_KERNELS_H
@@ -0,0 +1,204 @@
+#include "haar_kernels.h"
+#include "cpu_features.h"
+
+#if defined(QUASAR_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON)
+#include <arm_neon.h>
+#endif
+
+// --- Scalar reference ---
+
+static void forwardRowScalar(const float* in, float* lo, float* hi, int n) {
+    for (int i = 0; i < n; ++i) {
+        float a = in[2 * i];
+        float b = in[2 * i + 1];
+        lo[i] = (a + b) / 2.0f;
+        hi[i] = (a - b);
+    }
+}
+
+static void inverseRowScalar(const float* lo, const float* hi, float* out, int n) {
+    for (int i = 0; i < n; ++i) {
+        // Reconstruction:
+        // a = avg + detail / 2
+        // b = avg - detail / 2
+        out[2 * i] = lo[i] + hi[i] / 2.0f;
+        out[2 * i + 1] = lo[i] - hi[i] / 2.0f;
+    }
+}
+
+static void forwardPairScalar(const float* a, const float* b, float* lo, float* hi, int n) {
+    for (int i = 0; i < n; ++i) {
+        lo[i] = (a[i] + b[i]) / 2.0f;
+        hi[i] = a[i] - b[i];
+    }
+}
+
+static void inversePairScalar(const float* lo, const float* hi, float* a, float* b, int n) {
+    for (int i = 0; i < n; ++i) {
+        a[i] = lo[i] + hi[i] / 2.0f;
+        b[i] = lo[i] - hi[i] / 2.0f;
+    }
+}
+
+// --- AVX2 ---
+
+#if defined(QUASAR_X86)
+/**
+ * AVX2 Optimized Haar 1D Transform
+ *
+ * Shuffle Logic (De-interleaving):
+ * We start with 8 floats in a YMM register: [a0, b0, a1, b1, a2, b2, a3, b3]
+ * We use _mm256_permutevar8x32_ps with indices [0, 2, 4, 6, 1, 3, 5, 7]
+ * This separates the vector into two 128-bit halves:
+ *   Low 128-bit:  [a0, a1, a2, a3] (Even pixels / A)
+ *   High 128-bit: [b0, b1, b2, b3] (Odd pixels / B)
+ * Two such vectors are recombined with _mm256_permute2f128_ps into 8 evens
+ * and 8 odds, and Avg = (A+B)*0.5 and Diff = (A-B) are computed 8-wide.
+ */
+QUASAR_TARGET_AVX2
+static void forwardRowAVX2(const float* in, float* lo, float* hi, int n) {
+    const __m256i mask = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 v0 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(in + 2 * i), mask);
+        __m256 v1 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(in + 2 * i + 8), mask);
+        __m256 evens = _mm256_permute2f128_ps(v0, v1, 0x20);
+        __m256 odds = _mm256_permute2f128_ps(v0, v1, 0x31);
+        _mm256_storeu_ps(lo + i, _mm256_mul_ps(_mm256_add_ps(evens, odds), half));
+        _mm256_storeu_ps(hi + i, _mm256_sub_ps(evens, odds));
+    }
+    forwardRowScalar(in + 2 * i, lo + i, hi + i, n - i);
+}
+
+/**
+ * Inverse: a = lo + hi*0.5, b = lo - hi*0.5, then re-interleave.
+ * unpacklo/unpackhi interleave within each 128-bit lane:
+ *   [a0 b0 a1 b1 | a4 b4 a5 b5] and [a2 b2 a3 b3 | a6 b6 a7 b7]
+ * and permute2f128 stitches the lanes back into pixel order.
+ */
+QUASAR_TARGET_AVX2
+static void inverseRowAVX2(const float* lo, const float* hi, float* out, int n) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 l = _mm256_loadu_ps(lo + i);
+        __m256 d = _mm256_mul_ps(_mm256_loadu_ps(hi + i), half);
+        __m256 a = _mm256_add_ps(l, d);
+        __m256 b = _mm256_sub_ps(l, d);
+        __m256 ab0 = _mm256_unpacklo_ps(a, b);
+        __m256 ab1 = _mm256_unpackhi_ps(a, b);
+        _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(ab0, ab1, 0x20));
+        _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(ab0, ab1, 0x31));
+    }
+    inverseRowScalar(lo + i, hi + i, out + 2 * i, n - i);
+}
+
+QUASAR_TARGET_AVX2
+static void forwardPairAVX2(const float* a, const float* b, float* lo, float* hi, int n) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(lo + i, _mm256_mul_ps(_mm256_add_ps(va, vb), half));
+        _mm256_storeu_ps(hi + i, _mm256_sub_ps(va, vb));
+    }
+    forwardPairScalar(a + i, b + i, lo + i, hi + i, n - i);
+}
+
+QUASAR_TARGET_AVX2
+static void inversePairAVX2(const float* lo, const float* hi, float* a, float* b, int n) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 l = _mm256_loadu_ps(lo + i);
+        __m256 d = _mm256_mul_ps(_mm256_loadu_ps(hi + i), half);
+        _mm256_storeu_ps(a + i, _mm256_add_ps(l, d));
+        _mm256_storeu_ps(b + i, _mm256_sub_ps(l, d));
+    }
+    inversePairScalar(lo + i, hi + i, a + i, b + i, n - i);
+}
+#endif
+
+// --- NEON ---
+
+#if defined(QUASAR_NEON)
+// vld2q/vst2q do the (de)interleave in the load/store unit for free.
+static void forwardRowNEON(const float* in, float* lo, float* hi, int n) {
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        float32x4x2_t ab = vld2q_f32(in + 2 * i);
+        vst1q_f32(lo + i, vmulq_n_f32(vaddq_f32(ab.val[0], ab.val[1]), 0.5f));
+        vst1q_f32(hi + i, vsubq_f32(ab.val[0], ab.val[1]));
+    }
+    forwardRowScalar(in + 2 * i, lo + i, hi + i, n - i);
+}
+
+static void inverseRowNEON(const float* lo, const float* hi, float* out, int n) {
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        float32x4_t l = vld1q_f32(lo + i);
+        float32x4_t d = vmulq_n_f32(vld1q_f32(hi + i), 0.5f);
+        float32x4x2_t ab;
+        ab.val[0] = vaddq_f32(l, d);
+        ab.val[1] = vsubq_f32(l, d);
+        vst2q_f32(out + 2 * i, ab);
+    }
+    inverseRowScalar(lo + i, hi + i, out + 2 * i, n - i);
+}
+
+static void forwardPairNEON(const float* a, const float* b, float* lo, float* hi, int n) {
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = vld1q_f32(b + i);
+        vst1q_f32(lo + i, vmulq_n_f32(vaddq_f32(va, vb), 0.5f));
+        vst1q_f32(hi + i, vsubq_f32(va, vb));
+    }
+    forwardPairScalar(a + i, b + i, lo + i, hi + i, n - i);
+}
+
+static void inversePairNEON(const float* lo, const float* hi, float* a, float* b, int n) {
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        float32x4_t l = vld1q_f32(lo + i);
+        float32x4_t d = vmulq_n_f32(vld1q_f32(hi + i), 0.5f);
+        vst1q_f32(a + i, vaddq_f32(l, d));
+        vst1q_f32(b + i, vsubq_f32(l, d));
+    }
+    inversePairScalar(lo + i, hi + i, a + i, b + i, n - i);
+}
+#endif
+
+// --- Dispatch ---
+
+const HaarKernels& haarScalarKernels() {
+    static const HaarKernels k = {"scalar", forwardRowScalar, inverseRowScalar, forwardPairScalar, inversePairScalar};
+    return k;
+}
+
+static const HaarKernels& selectKernels() {
+#if defined(QUASAR_X86)
+    if (cpuFeatures().avx2) {
+        static const HaarKernels k = {"avx2", forwardRowAVX2, inverseRowAVX2, forwardPairAVX2, inversePairAVX2};
+        return k;
+    }
+#endif
+#if defined(QUASAR_NEON)
+    if (cpuFeatures().neon) {
+        static const HaarKernels k = {"neon", forwardRowNEON, inverseRowNEON, forwardPairNEON, inversePairNEON};
+        return k;
+    }
+#endif
+    return haarScalarKernels();
+}
+
+const HaarKernels& haarKernels() {
+    static const HaarKernels& k = selectKernels();
+    return k;
+}
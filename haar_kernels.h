@@ -0,0 +1,29 @@
+#ifndef HAAR_KERNELS_H
+#define HAAR_KERNELS_H
+
+// Low-level Haar lifting kernels used by the 2D transform in wavelet.cpp.
+// Every implementation produces bit-identical results, so frames encoded on
+// an AVX2 drone decode exactly on a NEON or scalar ground station.
+struct HaarKernels {
+    const char* name;
+
+    // Row pass: de-interleave in[0..2n) into averages lo[0..n) and details hi[0..n)
+    void (*forwardRow)(const float* in, float* lo, float* hi, int n);
+
+    // Inverse row pass: interleave lo/hi back into out[0..2n)
+    void (*inverseRow)(const float* lo, const float* hi, float* out, int n);
+
+    // Column pass on two rows a, b (n contiguous samples each)
+    void (*forwardPair)(const float* a, const float* b, float* lo, float* hi, int n);
+
+    // Inverse column pass back into rows a, b
+    void (*inversePair)(const float* lo, const float* hi, float* a, float* b, int n);
+};
+
+// Portable reference kernels
+const HaarKernels& haarScalarKernels();
+
+// Best kernels for the running CPU (selected once via cpuFeatures())
+const HaarKernels& haarKernels();
+
+#endif // HAAR_KERNELS_H
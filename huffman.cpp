@@ -1,166 +1,473 @@
 #include "huffman.h"
-#include <queue>
-#include <iostream>
+#include "varint.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <cstring>
+#include <bit>
 
+// Big-endian 64-bit store; the bitstream is MSB-first regardless of host order.
+static inline void storeBE64(uint8_t* dst, uint64_t v) {
+    if constexpr (std::endian::native == std::endian::little) {
+#if defined(_MSC_VER)
+        v = _byteswap_uint64(v);
+#else
+        v = __builtin_bswap64(v);
+#endif
+    }
+    std::memcpy(dst, &v, sizeof(v));
+}
+
+/**
+ * 64-bit bit accumulator (MSB-first).
+ *
+ * Codes are shifted into the low end of `acc`. After a flush at most 7 bits
+ * remain pending, and codes are at most kMaxCodeLength (14) bits, so four
+ * codes can always be appended before the next flush (7 + 4 * 14 < 64).
+ * A flush stores the whole accumulator as one unaligned 64-bit word and
+ * advances by the number of complete bytes, so there is no branch and no
+ * push_back in the hot loop. The output needs kSlack bytes of headroom for
+ * the final word store.
+ */
 class BitWriter {
 public:
-    std::vector<uint8_t> data;
-    uint8_t buffer = 0;
-    int bitCount = 0;
+    static constexpr size_t kSlack = 8;
 
-    void writeBit(int bit) {
-        buffer <<= 1;
-        if (bit) buffer |= 1;
-        bitCount++;
-        if (bitCount == 8) {
-            data.push_back(buffer);
-            buffer = 0;
-            bitCount = 0;
-        }
+    explicit BitWriter(uint8_t* out) : out(out) {}
+
+    inline void put(uint32_t code, int len) {
+        acc = (acc << len) | code;
+        bits += len;
+    }
+
+    inline void flushBytes() {
+        if (bits == 0) return;
+        storeBE64(out, acc << (64 - bits));
+        out += bits >> 3;
+        bits &= 7;
     }
 
     void flush() {
-        if (bitCount > 0) {
-            buffer <<= (8 - bitCount);
-            data.push_back(buffer);
+        flushBytes();
+        if (bits > 0) {
+            // Trailing partial byte, already stored left-aligned by flushBytes
+            out++;
+            bits = 0;
         }
     }
+
+private:
+    uint8_t* out;
+    uint64_t acc = 0;
+    int bits = 0;
 };
 
+static inline uint64_t loadBE64(const uint8_t* src) {
+    uint64_t v;
+    std::memcpy(&v, src, sizeof(v));
+    if constexpr (std::endian::native == std::endian::little) {
+#if defined(_MSC_VER)
+        v = _byteswap_uint64(v);
+#else
+        v = __builtin_bswap64(v);
+#endif
+    }
+    return v;
+}
+
+/**
+ * Word-at-a-time MSB-first bit reader.
+ *
+ * `buf` holds the next `bits` stream bits left-aligned. While at least 8
+ * input bytes remain, a refill is one unaligned 64-bit load that tops the
+ * buffer up to 56..63 bits without branching on the exact count. Near the end
+ * of the input it falls back to whole bytes, so `bits` only ever counts real
+ * stream bits and a truncated stream is detected rather than decoded from
+ * zero padding.
+ */
 class BitReader {
 public:
-    const std::vector<uint8_t>& data;
-    size_t byteIdx;
-    int bitIdx;
-
-    BitReader(const std::vector<uint8_t>& d, size_t offset) : data(d), byteIdx(offset), bitIdx(7) {}
+    BitReader(const uint8_t* begin, const uint8_t* end) : p(begin), end(end) {}
 
-    int readBit() {
-        if (byteIdx >= data.size()) return -1;
-        int bit = (data[byteIdx] >> bitIdx) & 1;
-        bitIdx--;
-        if (bitIdx < 0) {
-            bitIdx = 7;
-            byteIdx++;
+    inline void refill() {
+        if (end - p >= 8) {
+            buf |= loadBE64(p) >> bits;
+            p += (63 - bits) >> 3;
+            bits |= 56;
+        } else {
+            while (bits <= 56 && p < end) {
+                buf |= static_cast<uint64_t>(*p++) << (56 - bits);
+                bits += 8;
+            }
         }
-        return bit;
     }
+
+    inline bool canRefillWord() const { return end - p >= 8; }
+    inline uint32_t peek(int n) const { return static_cast<uint32_t>(buf >> (64 - n)); }
+    inline void consume(int n) { buf <<= n; bits -= n; }
+    inline int available() const { return bits; }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    uint64_t buf = 0;
+    int bits = 0;
 };
 
-std::shared_ptr<HuffmanCodec::Node> HuffmanCodec::buildTree(const std::vector<uint32_t>& frequencies) {
-    std::priority_queue<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>, Compare> pq;
+HuffmanCodec::Lengths HuffmanCodec::buildCodeLengths(const std::array<uint32_t, 256>& frequencies) {
+    Lengths lengths{};
+    std::array<uint64_t, 256> freq;
+    std::copy(frequencies.begin(), frequencies.end(), freq.begin());
 
-    for (int i = 0; i < 256; ++i) {
-        if (frequencies[i] > 0) {
-            pq.push(std::make_shared<Node>(static_cast<uint8_t>(i), frequencies[i]));
+    while (true) {
+        // Min-heap of (weight, node). Leaves are nodes 0..255 and internal nodes
+        // are numbered from 256 in creation order; using the node id as the tie
+        // breaker makes the tree identical on every platform. At most 256 items
+        // and 511 nodes, so the heap and the tree live on the stack.
+        using Item = std::pair<uint64_t, int>;
+        std::array<Item, 256> heap;
+        size_t size = 0;
+        for (int i = 0; i < 256; ++i) {
+            if (freq[i] > 0) heap[size++] = {freq[i], i};
+        }
+
+        if (size == 0) return lengths;
+        if (size == 1) {
+            // Handle single character case: one 1-bit code
+            lengths[heap[0].second] = 1;
+            return lengths;
+        }
+
+        const auto greater = std::greater<Item>();
+        std::make_heap(heap.begin(), heap.begin() + size, greater);
+        auto pop = [&] {
+            std::pop_heap(heap.begin(), heap.begin() + size, greater);
+            return heap[--size];
+        };
+
+        std::array<int, 511> parent;
+        parent.fill(-1);
+        int nodes = 256;
+        while (size > 1) {
+            Item left = pop();
+            Item right = pop();
+            int node = nodes++;
+            parent[left.second] = node;
+            parent[right.second] = node;
+            heap[size++] = {left.first + right.first, node};
+            std::push_heap(heap.begin(), heap.begin() + size, greater);
+        }
+
+        // Parents are always created after their children, so walking the
+        // nodes from the root down resolves every depth in one pass.
+        std::array<int, 511> depth{};
+        for (int n = nodes - 2; n >= 0; --n) {
+            if (parent[n] >= 0) depth[n] = depth[parent[n]] + 1;
+        }
+
+        int maxDepth = 0;
+        for (int i = 0; i < 256; ++i) {
+            if (freq[i] > 0) maxDepth = std::max(maxDepth, depth[i]);
+        }
+
+        if (maxDepth <= kMaxCodeLength) {
+            for (int i = 0; i < 256; ++i) {
+                lengths[i] = freq[i] > 0 ? static_cast<uint8_t>(depth[i]) : 0;
+            }
+            return lengths;
+        }
+
+        // Too deep (heavily skewed input): flatten the distribution and retry.
+        for (auto& f : freq) {
+            if (f > 0) f = (f + 1) / 2;
         }
     }
+}
 
-    // Handle single character case
-    if (pq.empty()) return nullptr;
-    if (pq.size() == 1) {
-        auto lone = pq.top();
-        pq.pop();
-        return std::make_shared<Node>(lone->freq, lone, nullptr);
+HuffmanCodec::Codes HuffmanCodec::buildCanonicalCodes(const Lengths& lengths) {
+    Codes codes{};
+    int count[kMaxCodeLength + 1] = {0};
+    for (uint8_t len : lengths) {
+        if (len) count[len]++;
     }
 
-    while (pq.size() != 1) {
-        auto left = pq.top(); pq.pop();
-        auto right = pq.top(); pq.pop();
-        uint32_t sum = left->freq + right->freq;
-        pq.push(std::make_shared<Node>(sum, left, right));
+    // First code of each length; count[0] is zero so length 1 starts at 0
+    uint32_t next[kMaxCodeLength + 1] = {0};
+    uint32_t code = 0;
+    for (int len = 1; len <= kMaxCodeLength; ++len) {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
     }
 
-    return pq.top();
+    for (int s = 0; s < 256; ++s) {
+        if (lengths[s]) codes[s] = next[lengths[s]]++;
+    }
+    return codes;
 }
 
-void HuffmanCodec::generateCodes(const std::shared_ptr<Node>& root, const std::string& str, std::map<uint8_t, std::string>& huffmanCode) {
-    if (!root) return;
-
-    if (root->isLeaf()) {
-        huffmanCode[root->ch] = str.empty() ? "0" : str;
-        return;
+void HuffmanCodec::buildDecodeTable(const Lengths& lengths, DecodeTable& table) {
+    std::memset(&table, 0, sizeof(table));
+    for (uint8_t len : lengths) {
+        if (len) table.count[len]++;
     }
 
-    generateCodes(root->left, str + "0", huffmanCode);
-    generateCodes(root->right, str + "1", huffmanCode);
-}
+    uint32_t code = 0;
+    uint16_t index = 0;
+    for (int len = 1; len <= kMaxCodeLength; ++len) {
+        code = (code + table.count[len - 1]) << 1;
+        table.firstCode[len] = code;
+        table.firstIndex[len] = index;
+        index += table.count[len];
+    }
 
-std::vector<uint8_t> HuffmanCodec::compress(const std::vector<uint8_t>& input) {
-    if (input.empty()) return {};
+    // Symbols in canonical order; short codes also fill every single-symbol
+    // slot that starts with their bit pattern.
+    Codes codes = buildCanonicalCodes(lengths);
+    uint16_t single[1 << kLookupBits] = {0}; // (symbol << 4) | length
+    uint16_t fill[kMaxCodeLength + 1] = {0};
+    for (int s = 0; s < 256; ++s) {
+        int len = lengths[s];
+        if (!len) continue;
+        table.sorted[table.firstIndex[len] + fill[len]++] = static_cast<uint8_t>(s);
+        if (len <= kLookupBits) {
+            uint32_t first = codes[s] << (kLookupBits - len);
+            uint32_t span = 1u << (kLookupBits - len);
+            for (uint32_t k = 0; k < span; ++k) {
+                single[first + k] = static_cast<uint16_t>((s << 4) | len);
+            }
+        }
+    }
 
-    // 1. Frequency Analysis
-    std::vector<uint32_t> frequencies(256, 0);
-    for (uint8_t b : input) {
-        frequencies[b]++;
+    // Pair up: after the first symbol, the remaining bits of the index are the
+    // start of the next code. Take it too if it ends within kLookupBits.
+    const uint32_t mask = (1u << kLookupBits) - 1;
+    for (uint32_t idx = 0; idx <= mask; ++idx) {
+        uint16_t first = single[idx];
+        int len0 = first & 0xF;
+        if (!len0) continue;
+        uint32_t entry = (static_cast<uint32_t>(len0) << 24) | ((first >> 4) << 8) | (1u << 4) | len0;
+        uint16_t second = single[(idx << len0) & mask];
+        int len1 = second & 0xF;
+        if (len1 && len0 + len1 <= kLookupBits) {
+            entry = (static_cast<uint32_t>(len0) << 24) | (static_cast<uint32_t>(second >> 4) << 16) |
+                    ((first >> 4) << 8) | (2u << 4) | (len0 + len1);
+        }
+        table.fast[idx] = entry;
     }
+}
 
-    // 2. Build Tree and Codes
-    auto root = buildTree(frequencies);
-    std::map<uint8_t, std::string> huffmanCode;
-    generateCodes(root, "", huffmanCode);
+/**
+ * Code-length table.
+ *
+ * Only the 256 code lengths (0..kMaxCodeLength, 4 bits each) are sent; the
+ * canonical codes follow from them. Two encodings, whichever is smaller:
+ *   0x00 + 128 bytes   Dense: two lengths per byte, symbol 2k in the high nibble
+ *   0x01 + N + N bytes Runs: (length << 4) | (run - 1), runs of 1..16 symbols
+ * Text and masked-image payloads use few distinct symbols, so the long zero
+ * runs typically shrink the table to a few dozen bytes.
+ */
+void HuffmanCodec::writeLengthTable(const Lengths& lengths, std::vector<uint8_t>& out) {
+    uint8_t runs[256];
+    int count = 0;
+    for (int s = 0; s < 256;) {
+        int run = 1;
+        while (s + run < 256 && run < 16 && lengths[s + run] == lengths[s]) run++;
+        runs[count++] = static_cast<uint8_t>((lengths[s] << 4) | (run - 1));
+        s += run;
+    }
 
-    // 3. Serialize Header (Frequency Table)
-    std::vector<uint8_t> output;
-    for (int i = 0; i < 256; ++i) {
-        uint32_t freq = frequencies[i];
-        output.push_back((freq >> 0) & 0xFF);
-        output.push_back((freq >> 8) & 0xFF);
-        output.push_back((freq >> 16) & 0xFF);
-        output.push_back((freq >> 24) & 0xFF);
+    if (count < 128) {
+        out.push_back(0x01);
+        out.push_back(static_cast<uint8_t>(count));
+        out.insert(out.end(), runs, runs + count);
+    } else {
+        out.push_back(0x00);
+        for (int s = 0; s < 256; s += 2) {
+            out.push_back(static_cast<uint8_t>((lengths[s] << 4) | lengths[s + 1]));
+        }
     }
+}
 
-    // 4. Encode Data
-    BitWriter writer;
-    for (uint8_t b : input) {
-        for (char bit : huffmanCode[b]) {
-            writer.writeBit(bit == '1');
+bool HuffmanCodec::readLengthTable(const uint8_t*& p, const uint8_t* end, Lengths& lengths) {
+    if (p >= end) return false;
+    uint8_t mode = *p++;
+    if (mode == 0x00) {
+        if (end - p < 128) return false;
+        for (int s = 0; s < 256; s += 2, ++p) {
+            lengths[s] = *p >> 4;
+            lengths[s + 1] = *p & 0xF;
+        }
+    } else if (mode == 0x01) {
+        if (p >= end) return false;
+        int count = *p++;
+        if (end - p < count) return false;
+        int s = 0;
+        for (int k = 0; k < count; ++k, ++p) {
+            int run = (*p & 0xF) + 1;
+            if (s + run > 256) return false;
+            std::fill(lengths.begin() + s, lengths.begin() + s + run, static_cast<uint8_t>(*p >> 4));
+            s += run;
         }
+        if (s != 256) return false;
+    } else {
+        return false;
     }
-    writer.flush();
 
-    output.insert(output.end(), writer.data.begin(), writer.data.end());
+    // Reject lengths the encoder can't produce and over-subscribed codes
+    // (Kraft sum above 1), which would make the lookup table inconsistent.
+    uint32_t kraft = 0;
+    for (uint8_t len : lengths) {
+        if (len > kMaxCodeLength) return false;
+        if (len) kraft += 1u << (kMaxCodeLength - len);
+    }
+    return kraft > 0 && kraft <= (1u << kMaxCodeLength);
+}
+
+std::vector<uint8_t> HuffmanCodec::compress(const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> output;
+    compress(input, output);
     return output;
 }
 
-std::vector<uint8_t> HuffmanCodec::decompress(const std::vector<uint8_t>& input) {
-    if (input.size() < 1024) return {};
+void HuffmanCodec::compress(std::span<const uint8_t> input, std::vector<uint8_t>& output) {
+    output.clear();
+    if (input.empty()) return;
+
+    // 1. Frequency Analysis (four interleaved histograms avoid store-to-load
+    //    stalls on runs of the same byte, e.g. the 0x00 high bytes of coefficients)
+    std::array<uint32_t, 256> frequencies;
+    {
+        uint32_t hist[4][256] = {{0}};
+        size_t i = 0;
+        const size_t n = input.size();
+        for (; i + 4 <= n; i += 4) {
+            hist[0][input[i]]++;
+            hist[1][input[i + 1]]++;
+            hist[2][input[i + 2]]++;
+            hist[3][input[i + 3]]++;
+        }
+        for (; i < n; ++i) hist[0][input[i]]++;
+        for (int s = 0; s < 256; ++s) {
+            frequencies[s] = hist[0][s] + hist[1][s] + hist[2][s] + hist[3][s];
+        }
+    }
 
-    // 1. Read Frequency Table
-    std::vector<uint32_t> frequencies(256);
+    // 2. Build flat code/length table: (code << 8) | length per symbol
+    Lengths lengths = buildCodeLengths(frequencies);
+    Codes codes = buildCanonicalCodes(lengths);
+    uint32_t table[256];
+    uint64_t totalBits = 0;
     for (int i = 0; i < 256; ++i) {
-        uint32_t freq = 0;
-        freq |= static_cast<uint32_t>(input[i * 4 + 0]);
-        freq |= static_cast<uint32_t>(input[i * 4 + 1]) << 8;
-        freq |= static_cast<uint32_t>(input[i * 4 + 2]) << 16;
-        freq |= static_cast<uint32_t>(input[i * 4 + 3]) << 24;
-        frequencies[i] = freq;
+        table[i] = (codes[i] << 8) | lengths[i];
+        totalBits += static_cast<uint64_t>(frequencies[i]) * lengths[i];
+    }
+
+    // 3. Serialize Header (symbol count + code-length table)
+    writeVarint(input.size(), output);
+    writeLengthTable(lengths, output);
+    const size_t headerBytes = output.size();
+    const size_t payloadBytes = (totalBits + 7) / 8;
+    output.resize(headerBytes + payloadBytes + BitWriter::kSlack);
+
+    // 4. Encode Data, four symbols per flush
+    BitWriter writer(output.data() + headerBytes);
+    const uint8_t* in = input.data();
+    const size_t n = input.size();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t e0 = table[in[i]];
+        uint32_t e1 = table[in[i + 1]];
+        uint32_t e2 = table[in[i + 2]];
+        uint32_t e3 = table[in[i + 3]];
+        // Merge pairs first so only two shifts sit on the accumulator's
+        // dependency chain per four symbols
+        int l1 = e1 & 0xFF, l3 = e3 & 0xFF;
+        writer.put(((e0 >> 8) << l1) | (e1 >> 8), (e0 & 0xFF) + l1);
+        writer.put(((e2 >> 8) << l3) | (e3 >> 8), (e2 & 0xFF) + l3);
+        writer.flushBytes();
     }
+    for (; i < n; ++i) {
+        uint32_t e = table[in[i]];
+        writer.put(e >> 8, e & 0xFF);
+    }
+    writer.flush();
+
+    output.resize(headerBytes + payloadBytes);
+}
 
+std::vector<uint8_t> HuffmanCodec::decompress(std::span<const uint8_t> input) {
+    // 1. Read symbol count and code lengths
+    const uint8_t* p = input.data();
+    const uint8_t* end = p + input.size();
     uint64_t totalChars = 0;
-    for (uint32_t f : frequencies) totalChars += f;
-    if (totalChars == 0) return {};
+    Lengths lengths{};
+    if (!readVarint(p, end, totalChars) || totalChars == 0) return {};
+    if (!readLengthTable(p, end, lengths)) return {};
 
-    // 2. Rebuild Tree
-    auto root = buildTree(frequencies);
-    if (!root) return {};
+    // 2. Build the canonical lookup table straight from the lengths
+    DecodeTable table;
+    buildDecodeTable(lengths, table);
 
-    // 3. Decode Bitstream
-    std::vector<uint8_t> output;
-    BitReader reader(input, 1024);
-    
-    for (uint64_t i = 0; i < totalChars; ++i) {
-        auto curr = root;
-        while (!curr->isLeaf()) {
-            int bit = reader.readBit();
-            if (bit == -1) break;
-            curr = (bit == 0) ? curr->left : curr->right;
-            // Handle edge case of single character tree
-            if (!curr) break; 
+    // Every symbol costs at least one bit, so a header claiming more symbols
+    // than the stream has bits is truncated or corrupt: never allocate past that.
+    const uint64_t streamBits = static_cast<uint64_t>(end - p) * 8;
+    const size_t outSize = static_cast<size_t>(std::min(totalChars, streamBits));
+
+    // 3. Decode Bitstream into a presized buffer
+    std::vector<uint8_t> output(outSize + 1);
+    uint8_t* out = output.data();
+    BitReader reader(p, end);
+
+    // Long code (> kLookupBits): walk the canonical ranges. Sets len to
+    // kMaxCodeLength + 1 when the bits match no code.
+    auto decodeLong = [&](int& len) -> uint8_t {
+        for (len = kLookupBits + 1; len <= kMaxCodeLength; ++len) {
+            uint32_t offset = reader.peek(len) - table.firstCode[len];
+            if (offset < table.count[len]) return table.sorted[table.firstIndex[len] + offset];
+        }
+        return 0;
+    };
+
+    size_t i = 0;
+    bool corrupt = false;
+
+    // Fast path: a refill with >= 8 input bytes left yields >= 56 real bits,
+    // enough for four lookups of up to kMaxCodeLength bits each, and every
+    // lookup yields one or two symbols with no bounds checks. Both symbol
+    // slots are always written; the output keeps one byte of slack for that.
+    while (reader.canRefillWord() && outSize - i >= 8) {
+        reader.refill();
+        for (int k = 0; k < 4; ++k) {
+            uint32_t entry = table.fast[reader.peek(kLookupBits)];
+            if (entry) {
+                out[i] = static_cast<uint8_t>(entry >> 8);
+                out[i + 1] = static_cast<uint8_t>(entry >> 16);
+                i += (entry >> 4) & 0x3;
+                reader.consume(entry & 0xF);
+            } else {
+                int len;
+                uint8_t sym = decodeLong(len);
+                if (len > kMaxCodeLength) { corrupt = true; break; }
+                reader.consume(len);
+                out[i++] = sym;
+            }
         }
-        if (curr) output.push_back(curr->ch);
+        if (corrupt) break;
+    }
+
+    // Tail: one symbol at a time with byte-wise refills, checking every code
+    // against the real bits left so a truncated stream is not padded out
+    while (!corrupt && i < outSize) {
+        reader.refill();
+        uint32_t entry = table.fast[reader.peek(kLookupBits)];
+        int len = static_cast<int>(entry >> 24);
+        uint8_t sym = static_cast<uint8_t>(entry >> 8);
+        if (!entry) sym = decodeLong(len);
+        if (len > kMaxCodeLength || len > reader.available()) break;
+        reader.consume(len);
+        out[i++] = sym;
     }
 
+    output.resize(i);
     return output;
 }
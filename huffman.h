@@ -3,40 +3,61 @@
 
 #include <vector>
 #include <cstdint>
-#include <string>
-#include <map>
-#include <memory>
+#include <array>
+#include <span>
 
 class HuffmanCodec {
 public:
     // Compresses input data using Static Huffman Coding.
-    // The output includes 1024 bytes of frequency table (256 * 4 bytes) followed by bitstream.
+    // The output is the symbol count (varint), a compact code-length table
+    // (at most 129 bytes) and the canonical-code bitstream, MSB-first.
     std::vector<uint8_t> compress(const std::vector<uint8_t>& input);
+    // Same, into `output` (replacing its contents): reusing one output buffer,
+    // compression allocates nothing once the buffer has grown to fit
+    void compress(std::span<const uint8_t> input, std::vector<uint8_t>& output);
 
     // Decompresses data compressed by the compress function.
-    std::vector<uint8_t> decompress(const std::vector<uint8_t>& input);
+    std::vector<uint8_t> decompress(std::span<const uint8_t> input);
 
-private:
-    struct Node {
-        uint8_t ch;
-        uint32_t freq;
-        std::shared_ptr<Node> left, right;
+    // Longest code the builder will emit. Four codes plus a partial byte
+    // always fit the encoder's 64-bit bit accumulator between flushes.
+    static constexpr int kMaxCodeLength = 14;
 
-        Node(uint8_t c, uint32_t f) : ch(c), freq(f), left(nullptr), right(nullptr) {}
-        Node(uint32_t f, std::shared_ptr<Node> l, std::shared_ptr<Node> r) 
-            : ch(0), freq(f), left(l), right(r) {}
+    // Bits resolved by one decoder table lookup (one or two symbols); longer
+    // codes take the canonical fallback path.
+    static constexpr int kLookupBits = 11;
 
-        bool isLeaf() const { return !left && !right; }
+private:
+    using Lengths = std::array<uint8_t, 256>;
+    using Codes = std::array<uint32_t, 256>;
+
+    struct DecodeTable {
+        // Indexed by the next kLookupBits of the stream. Each entry decodes up
+        // to two symbols whose codes fit together in kLookupBits:
+        //   [3:0] total bits  [5:4] symbol count  [15:8] first symbol
+        //   [23:16] second symbol  [27:24] first symbol's length
+        // An all-zero entry means the first code is longer than kLookupBits.
+        uint32_t fast[1 << kLookupBits];
+
+        // Canonical layout per code length, for the long-code fallback
+        uint32_t firstCode[kMaxCodeLength + 1];
+        uint16_t count[kMaxCodeLength + 1];
+        uint16_t firstIndex[kMaxCodeLength + 1];
+        uint8_t sorted[256];
     };
 
-    struct Compare {
-        bool operator()(const std::shared_ptr<Node>& l, const std::shared_ptr<Node>& r) {
-            return l->freq > r->freq;
-        }
-    };
+    // Length-limited Huffman code lengths. Deterministic, so encoder and
+    // decoder derive identical codes from the same frequency table.
+    static Lengths buildCodeLengths(const std::array<uint32_t, 256>& frequencies);
+
+    // Canonical code assignment: shorter codes first, ties broken by symbol value
+    static Codes buildCanonicalCodes(const Lengths& lengths);
+
+    static void buildDecodeTable(const Lengths& lengths, DecodeTable& table);
 
-    std::shared_ptr<Node> buildTree(const std::vector<uint32_t>& frequencies);
-    void generateCodes(const std::shared_ptr<Node>& root, const std::string& str, std::map<uint8_t, std::string>& huffmanCode);
+    // Stream header serialization
+    static void writeLengthTable(const Lengths& lengths, std::vector<uint8_t>& out);
+    static bool readLengthTable(const uint8_t*& p, const uint8_t* end, Lengths& lengths);
 };
 
 #endif // HUFFMAN_H
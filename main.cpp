@@ -17,13 +17,26 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <span>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <csignal>
 
 // Core Quasar Libraries
 #include "quasar_format.h"
 #include "huffman.h"
 #include "wavelet.h"
-#include "chacha.h"
+#include "aead.h"
 #include "udp_link.h"
+#include "coeff_codec.h"
+#include "progressive.h"
+#include "stream_encoder.h"
+#include "tile_codec.h"
+#include "gcs_server.h"
+#include "archive_io.h"
+#include "pnm_io.h"
+#include "frame_ingest.h"
 
 namespace fs = std::filesystem;
 
@@ -52,6 +65,86 @@ void parse_hex_key(const std::string& hex, uint8_t* key) {
     }
 }
 
+// Verifies and decrypts an encrypted payload in place: ciphertext followed by
+// the Poly1305 tag, authenticated together with the raw header bytes. On
+// return `payload` covers just the plaintext. Returns false (payload
+// unusable) for a short frame or a bad tag.
+bool open_payload(const uint8_t* headerBytes, std::span<uint8_t>& payload, const uint8_t key[32], const uint8_t nonce[12]) {
+    if (payload.size() < ChaCha20Poly1305::kTagSize) return false;
+    const size_t dataSize = payload.size() - ChaCha20Poly1305::kTagSize;
+    bool ok = ChaCha20Poly1305::open(payload.first(dataSize),
+                                     std::span<const uint8_t>(headerBytes, sizeof(QuasarHeader)),
+                                     key, nonce, payload.data() + dataSize);
+    payload = payload.first(dataSize);
+    return ok;
+}
+
+// Tag check alone: the payload stays encrypted
+bool check_payload(const uint8_t* headerBytes, std::span<const uint8_t> payload, const uint8_t key[32], const uint8_t nonce[12]) {
+    if (payload.size() < ChaCha20Poly1305::kTagSize) return false;
+    const size_t dataSize = payload.size() - ChaCha20Poly1305::kTagSize;
+    return ChaCha20Poly1305::check(payload.first(dataSize), std::span<const uint8_t>(headerBytes, sizeof(QuasarHeader)),
+                                   key, nonce, payload.data() + dataSize);
+}
+
+// Decrypts a payload that check_payload has accepted and strips its tag
+void decrypt_checked_payload(std::span<uint8_t>& payload, const uint8_t key[32], const uint8_t nonce[12]) {
+    payload = payload.first(payload.size() - ChaCha20Poly1305::kTagSize);
+    ChaCha20Poly1305::decryptChecked(payload, key, nonce);
+}
+
+// Reverses the entropy and wavelet stages of a decrypted payload.
+// Visual frames (0x02) are reconstructed into `img`, anything else into `bytes`.
+bool decode_payload(const QuasarHeader& header, std::span<const uint8_t> payload, GrayImage& img, std::vector<uint8_t>& bytes) {
+    int levels = std::max<int>(1, header.wavelet_levels);
+    auto blank_image = [&] {
+        img = GrayImage(header.width, header.height);
+        img.maxVal = header.max_value ? header.max_value : 255;
+    };
+    if ((header.compression_flags & 0x04) && header.layer_count > 1) {
+        // A single progressive layer: the image rendered from just its bands
+        ProgressiveDecoder progressive;
+        if (!progressive.addLayer(header, payload)) return false;
+        progressive.render(img);
+        return true;
+    }
+    if (header.compression_flags & 0x08) {
+        blank_image();
+        return decodeTiles(payload, levels, header.scale, header.detail_scale, img);
+    }
+    if (header.compression_flags & 0x04) {
+        std::vector<int32_t> coeffs;
+        CoefficientCodec codec;
+        if (!codec.decode(payload, header.width, header.height, levels, coeffs)) return false;
+        blank_image();
+        dequantizeCoefficients(coeffs, img, header.scale, header.detail_scale, levels);
+        inverseTransform2D(img, levels);
+        return true;
+    }
+
+    HuffmanCodec codec;
+    bytes = codec.decompress(payload);
+    if (header.compression_flags & 0x02) {
+        blank_image();
+        if (!dequantize(bytes, img, header.scale, header.detail_scale, levels)) return false;
+        inverseTransform2D(img, levels);
+    }
+    return true;
+}
+
+// Ctrl-C / SIGTERM stop the GCS cleanly: queued frames are still handled and
+// a flight recording gets its index
+GcsServer* running_server = nullptr;
+void stop_server(int) {
+    if (running_server) running_server->stop();
+}
+
+// ...and end a shared-memory ingest stream, so the pipeline drains
+FrameRingReader* running_ring = nullptr;
+void stop_ring(int) {
+    if (running_ring) running_ring->stop();
+}
+
 // --- MAIN ---
 
 int main(int argc, char* argv[]) {
@@ -61,16 +154,36 @@ int main(int argc, char* argv[]) {
                   << "Usage: " << argv[0] << " <input/port> [options...]\n\n"
                   << "Modes:\n"
                   << "  --tx <ip> <port>      Stream mission data to GCS via UDP\n"
-                  << "  --rx <port>           Listen as GCS (Base Station)\n"
-                  << "  --unpack              Restore a local .qsr file to disk\n\n"
+                  << "  --rx <port>           Listen as GCS (Base Station), serving any number of drones\n"
+                  << "  --workers <n>         GCS decode threads (default: one per spare core)\n"
+                  << "  --unpack              Restore a local .qsr file, or every image of a .qsrm\n"
+                  << "                        flight recording, to disk\n"
+                  << "  --record <file.qsrm>  Append archives to one flight recording instead of\n"
+                  << "                        per-frame files (pack, --tx, --stream, --rx)\n"
+                  << "  --list                With --unpack on a recording: print its index\n"
+                  << "  --frame <sequence>    With --unpack on a recording: only this image\n"
+                  << "  --stream <dir|fifo>   Encode every PGM in a directory, or a PGM stream, on a\n"
+                  << "                        pipelined encoder (with --tx, --record, or stream_<n>.qsr files)\n"
+                  << "  --stream shm:<name>   ...or raw camera frames from a shared-memory frame ring\n"
+                  << "  --stream raw:<fifo>   ...or raw camera frames from a pipe (raw:- = stdin)\n"
+                  << "  --rate <mbps>         Tx pacing in Mbit/s, 0 = unpaced (default 100)\n"
+                  << "  --gso                 Use UDP segmentation offload for Tx (Linux)\n"
+                  << "  --fec <k> <m>         Add m Reed-Solomon parity chunks per k data chunks\n"
+                  << "  --progressive         Tx images as one layer per wavelet level, coarsest first\n\n"
                   << "Multi-ROI Logic (ISRO IRoC-U):\n"
                   << "  --roi <x> <y> <r>     Define high-detail target (Max 8)\n"
+                  << "  --falloff <px>        Soft foveation band around each ROI (default 0)\n"
                   << "  --est_x, --est_y, --est_z   Drone pose telemetry\n"
                   << "  --id <uint>           Target feature identification ID\n\n"
                   << "Security & Precision:\n"
-                  << "  --encrypt             Enable ChaCha20 encryption\n"
+                  << "  --encrypt             Enable ChaCha20-Poly1305 authenticated encryption\n"
                   << "  --key <hex>           Use 256-bit Pre-Shared Key\n"
-                  << "  --scale <float>       Quantization precision (default 10.0)\n";
+                  << "  --scale <float>       Quantization precision (default 10.0)\n"
+                  << "  --detail-scale <f>    Precision of detail subbands, HH at half (default: --scale)\n"
+                  << "  --levels <n>          Wavelet decomposition depth (default 3)\n"
+                  << "  --tile <px>           Code the image as independent px x px tiles in parallel\n"
+                  << "                        (default 256, 0 = whole frame)\n"
+                  << "  --entropy <mode>      Image entropy coder: coeff (default) or huffman\n";
         return 1;
     }
 
@@ -80,7 +193,19 @@ int main(int argc, char* argv[]) {
     bool mode_unpack = false, mode_tx = false, mode_rx = false, do_encrypt = false;
     std::string tx_ip = "127.0.0.1", manual_key = "";
     int tx_port = 0, rx_port = 0;
-    float scale = 10.0f;
+    unsigned rx_workers = 0;
+    float scale = 10.0f, detail_scale = 0.0f, roi_falloff = 0.0f;
+    int wavelet_levels = 3;
+    double tx_rate_mbps = 100.0;
+    bool tx_gso = false;
+    int fec_data = 0, fec_parity = 0;
+    bool progressive = false;
+    std::string stream_source;
+    std::string record_path;
+    bool list_only = false, has_frame = false;
+    uint32_t only_frame = 0;
+    bool coeff_coding = true;
+    int tile_size = 256;
 
     // ISRO Data States
     std::vector<ROI> mission_targets;
@@ -93,8 +218,22 @@ int main(int argc, char* argv[]) {
         if (arg == "--unpack") mode_unpack = true;
         else if (arg == "--tx" && i + 2 < argc) { mode_tx = true; tx_ip = argv[++i]; tx_port = std::stoi(argv[++i]); }
         else if (arg == "--rx" && i + 1 < argc) { mode_rx = true; rx_port = std::stoi(argv[++i]); }
+        else if (arg == "--workers" && i + 1 < argc) rx_workers = static_cast<unsigned>(std::stoul(argv[++i]));
         else if (arg == "--encrypt") do_encrypt = true;
+        else if (arg == "--rate" && i + 1 < argc) tx_rate_mbps = std::stod(argv[++i]);
+        else if (arg == "--gso") tx_gso = true;
+        else if (arg == "--progressive") progressive = true;
+        else if (arg == "--stream" && i + 1 < argc) stream_source = argv[++i];
+        else if (arg == "--record" && i + 1 < argc) record_path = argv[++i];
+        else if (arg == "--list") list_only = true;
+        else if (arg == "--frame" && i + 1 < argc) { has_frame = true; only_frame = static_cast<uint32_t>(std::stoul(argv[++i])); }
+        else if (arg == "--fec" && i + 2 < argc) { fec_data = std::stoi(argv[++i]); fec_parity = std::stoi(argv[++i]); }
         else if (arg == "--scale" && i + 1 < argc) scale = std::stof(argv[++i]);
+        else if (arg == "--detail-scale" && i + 1 < argc) detail_scale = std::stof(argv[++i]);
+        else if (arg == "--falloff" && i + 1 < argc) roi_falloff = std::stof(argv[++i]);
+        else if (arg == "--levels" && i + 1 < argc) wavelet_levels = std::stoi(argv[++i]);
+        else if (arg == "--tile" && i + 1 < argc) tile_size = std::stoi(argv[++i]);
+        else if (arg == "--entropy" && i + 1 < argc) coeff_coding = std::string(argv[++i]) != "huffman";
         else if (arg == "--key" && i + 1 < argc) manual_key = argv[++i];
         // Multi-ROI Handler
         else if (arg == "--roi" && i + 3 < argc) {
@@ -114,61 +253,264 @@ int main(int argc, char* argv[]) {
     //                            RECEIVER MODE (GCS)
     // =========================================================================
     if (mode_rx) {
-        std::cout << "[GCS] Listening on UDP Port " << rx_port << "..." << std::endl;
-        QuasarRx rx;
-        std::vector<uint8_t> frame;
-        
-        while (rx.listen(rx_port, frame)) {
-            if (frame.size() < sizeof(QuasarHeader)) continue;
+        GcsServer server(rx_workers);
+        std::cout << "[GCS] Listening on UDP Port " << rx_port << " (" << server.worker_count() << " decode workers)..." << std::endl;
+
+        // One PSK for the whole session, asked for on the first encrypted frame
+        uint8_t key[32];
+        std::once_flag key_once;
+        std::mutex print_mutex;
+        auto print = [&](const std::string& text, bool error = false) {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            (error ? std::cerr : std::cout) << text << std::flush;
+        };
+
+        // Every frame that authenticates, still encrypted, into one flight
+        // recording; a restarted GCS carries on with the same file
+        RecordingWriter recorder;
+        std::mutex record_mutex;
+        if (!record_path.empty()) {
+            if (!recorder.open(record_path, true)) return 1;
+            std::cout << "[GCS] Recording to " << record_path << " (" << recorder.frames() << " archives so far)" << std::endl;
+        }
+
+        // Progressive images in flight, per drone; each drone always lands on
+        // the same worker, so every worker owns its own map
+        std::vector<std::map<uint64_t, ProgressiveDecoder>> progressive(server.worker_count());
+
+        auto handle_frame = [&](unsigned worker, ReceivedFrame& received) {
+            std::vector<uint8_t>& frame = received.data;
+            const std::string drone = received.peer.to_string();
+            std::ostringstream log;
+            const RxStats& link = received.stats.link;
+            if (link.frames_evicted || link.chunks_recovered || link.duplicates || link.malformed || received.stats.frames_dropped_busy) {
+                log << "[Rx] Link: " << link.frames_completed << " frames, " << link.frames_evicted << " incomplete dropped ("
+                    << link.chunks_lost << " chunks lost), " << link.chunks_recovered << " chunks recovered by FEC, "
+                    << link.duplicates << " duplicates, " << link.malformed << " malformed, "
+                    << received.stats.frames_dropped_busy << " dropped while decoders were busy" << std::endl;
+            }
+            if (frame.size() < sizeof(QuasarHeader)) return;
 
             QuasarHeader header;
             std::memcpy(&header, frame.data(), sizeof(header));
-            if (std::strncmp(header.magic, "QSR1", 4) != 0) continue;
+            if (std::strncmp(header.magic, "QSR1", 4) != 0) return;
+            if (header.format_version != kQuasarFormatVersion) {
+                print("[Rx] " + drone + ": dropping frame, unsupported format version " + std::to_string(header.format_version) + "\n", true);
+                return;
+            }
 
             // --- DISPLAY MISSION TELEMETRY ---
-            std::cout << "\n----------------------------------------" << std::endl;
-            std::cout << "[!] INCOMING MISSION DATA | Frame ID: " << header.target_id << std::endl;
-            std::cout << " -> Drone Pose: (" << header.est_x << ", " << header.est_y << ", " << header.est_z << ")" << std::endl;
-            
+            log << "\n----------------------------------------" << std::endl;
+            log << "[!] INCOMING MISSION DATA | Drone " << drone << " | Frame ID: " << header.target_id << std::endl;
+            log << " -> Drone Pose: (" << header.est_x << ", " << header.est_y << ", " << header.est_z << ")" << std::endl;
+
             int active_rois = static_cast<int>(header.roi_count);
-            std::cout << " -> Saliency Bubbles Active: " << active_rois << std::endl;
+            log << " -> Saliency Bubbles Active: " << active_rois << std::endl;
             for(int k = 0; k < active_rois && k < 8; k++) {
-                std::cout << "    [" << k << "] Focus Point: (" << header.targets[k].x << ", " << header.targets[k].y << ") | Radius: " << header.targets[k].r << "px" << std::endl;
+                log << "    [" << k << "] Focus Point: (" << header.targets[k].x << ", " << header.targets[k].y << ") | Radius: " << header.targets[k].r << "px" << std::endl;
             }
-            std::cout << "----------------------------------------" << std::endl;
+            log << "----------------------------------------" << std::endl;
 
-            std::vector<uint8_t> payload(frame.begin() + sizeof(header), frame.end());
+            // Decrypted and decoded where it lies in the receive buffer
+            std::span<uint8_t> payload = std::span<uint8_t>(frame).subspan(sizeof(header));
 
             // --- Decryption Layer ---
-            if (header.compression_flags & 0x80) {
-                uint8_t key[32];
-                if (!manual_key.empty()) parse_hex_key(manual_key, key);
-                else { 
+            const bool encrypted = header.compression_flags & 0x80;
+            if (encrypted) {
+                std::call_once(key_once, [&] {
+                    if (!manual_key.empty()) { parse_hex_key(manual_key, key); return; }
+                    std::lock_guard<std::mutex> lock(print_mutex);
                     std::cout << "[Rx] Encrypted Frame. Paste PSK: ";
-                    std::string k; std::cin >> k; parse_hex_key(k, key); 
+                    std::string k; std::cin >> k; parse_hex_key(k, key);
+                });
+            }
+            auto record = [&] {
+                std::lock_guard<std::mutex> lock(record_mutex);
+                recorder.append(frame);
+            };
+            if (encrypted) {
+                // Authenticate before any decode work. When recording, the tag
+                // is checked once, the ciphertext recorded, and the payload
+                // then only deciphered; forged or corrupted frames stay out of
+                // the mission log.
+                bool authentic;
+                if (record_path.empty()) {
+                    authentic = open_payload(frame.data(), payload, key, header.nonce);
+                } else {
+                    authentic = check_payload(frame.data(), payload, key, header.nonce);
+                    if (authentic) {
+                        record();
+                        decrypt_checked_payload(payload, key, header.nonce);
+                    }
+                }
+                if (!authentic) {
+                    print(log.str());
+                    print("[Rx] " + drone + ": authentication failed, frame dropped.\n", true);
+                    return;
                 }
-                ChaCha20::process(payload, key, header.nonce);
+            } else if (!record_path.empty()) {
+                record();
+            }
+
+            // Output files are named per drone so a swarm's images never collide
+            std::string file_base = "rx_" + drone;
+            std::replace(file_base.begin(), file_base.end(), ':', '_');
+            file_base += "_" + std::to_string(header.sequence);
+
+            // --- Progressive layers: refine the drone's current image and re-render ---
+            if ((header.compression_flags & 0x04) && header.layer_count > 1) {
+                ProgressiveDecoder& decoder = progressive[worker][received.peer.key()];
+                if (!decoder.addLayer(header, payload)) {
+                    print(log.str());
+                    print("[Rx] " + drone + ": stale or corrupt layer " + std::to_string(header.layer) + ", dropped.\n", true);
+                    return;
+                }
+                GrayImage img(0, 0);
+                decoder.render(img);
+                std::string outName = file_base + ".pgm";
+                savePGM(outName, img);
+                log << "[Rx] " << (decoder.complete() ? "Visual Data Reconstructed" : "Preview") << " ("
+                    << decoder.layersReceived() << "/" << decoder.layerCount() << " layers): " << outName << std::endl;
+                print(log.str());
+                return;
             }
 
             // --- Decompression & Recovery ---
-            HuffmanCodec codec;
-            std::vector<uint8_t> decompressed = codec.decompress(payload);
-            std::string t_stamp = std::to_string(std::time(nullptr));
+            GrayImage img(0, 0);
+            std::vector<uint8_t> decompressed;
+            if (!decode_payload(header, payload, img, decompressed)) {
+                print(log.str());
+                print("[Rx] " + drone + ": corrupt payload, frame dropped.\n", true);
+                return;
+            }
 
             if (header.compression_flags & 0x02) {
-                GrayImage img(header.width, header.height);
-                dequantize(decompressed, img, header.scale);
-                inverseTransform2D(img);
-                std::string outName = "rx_" + t_stamp + ".pgm";
+                std::string outName = file_base + ".pgm";
                 savePGM(outName, img);
-                std::cout << "[Rx] Visual Data Reconstructed: " << outName << std::endl;
+                log << "[Rx] Visual Data Reconstructed: " << outName << std::endl;
             } else {
-                std::string outName = "rx_" + t_stamp + ".bin";
+                std::string outName = file_base + ".bin";
                 std::ofstream out(outName, std::ios::binary);
                 out.write((const char*)decompressed.data(), decompressed.size());
-                std::cout << "[Rx] Binary Data Recovered: " << outName << std::endl;
+                log << "[Rx] Binary Data Recovered: " << outName << std::endl;
+            }
+            print(log.str());
+        };
+
+        running_server = &server;
+        std::signal(SIGINT, stop_server);
+        std::signal(SIGTERM, stop_server);
+        if (!server.run(rx_port, handle_frame)) return 1;
+        return recorder.close() ? 0 : 1;
+    }
+
+    // =========================================================================
+    //                      STREAMING MODE (Pipelined Encoder)
+    // =========================================================================
+    if (!stream_source.empty()) {
+        StreamConfig config;
+        config.scale = scale;
+        config.detailScale = detail_scale;
+        config.falloff = roi_falloff;
+        config.levels = wavelet_levels;
+        config.targets = mission_targets;
+        config.estX = est_x; config.estY = est_y; config.estZ = est_z;
+        config.targetId = target_id;
+        config.encrypt = do_encrypt;
+        if (do_encrypt) {
+            if (manual_key.empty()) {
+                std::random_device rd;
+                for (auto& k : config.key) k = rd() & 0xFF;
+                print_hex("Generated PSK", config.key, 32);
+            } else {
+                parse_hex_key(manual_key, config.key);
+            }
+        }
+
+        // Source: the PGMs of a directory in name order, consecutive PGMs
+        // read from a file / FIFO until it closes, or raw frames from a
+        // capture process (shared-memory ring or pipe)
+        std::vector<fs::path> files;
+        std::ifstream stream_in;
+        size_t next_file = 0;
+        FrameRingReader ring;
+        RawFrameReader raw;
+        const bool from_ring = stream_source.rfind("shm:", 0) == 0;
+        const bool from_raw = stream_source.rfind("raw:", 0) == 0;
+        if (from_ring) {
+            if (!ring.open(stream_source.substr(4))) return 1;
+            running_ring = &ring;
+            std::signal(SIGINT, stop_ring);
+            std::signal(SIGTERM, stop_ring);
+            std::cout << "[Stream] Reading raw frames from shared memory " << stream_source.substr(4) << std::endl;
+        } else if (from_raw) {
+            if (!raw.open(stream_source.substr(4))) return 1;
+            std::cout << "[Stream] Reading raw frames from " << stream_source.substr(4) << std::endl;
+        } else if (fs::is_directory(stream_source)) {
+            for (const auto& entry : fs::directory_iterator(stream_source)) {
+                if (entry.path().extension() == ".pgm" || entry.path().extension() == ".ppm") files.push_back(entry.path());
             }
+            std::sort(files.begin(), files.end());
+            std::cout << "[Stream] " << files.size() << " frames in " << stream_source << std::endl;
+        } else {
+            stream_in.open(stream_source, std::ios::binary);
+            if (!stream_in) { std::cerr << "Cannot open stream source: " << stream_source << std::endl; return 1; }
+            std::cout << "[Stream] Reading frames from " << stream_source << std::endl;
         }
+        FrameSource source = [&](GrayImage& img) {
+            if (from_ring) return ring.next(img);
+            if (from_raw) return raw.next(img);
+            while (next_file < files.size()) {
+                if (loadPGM(files[next_file++].string(), img)) return true;
+                std::cerr << "[Stream] Skipping unreadable " << files[next_file - 1] << std::endl;
+            }
+            return stream_in.is_open() && readPGM(stream_in, img);
+        };
+
+        // Sink: the network, or one archive file per frame
+        QuasarTx tx;
+        if (mode_tx) {
+            tx.set_pacing(static_cast<uint64_t>(std::max(0.0, tx_rate_mbps) * 1e6));
+            if (tx_gso && !tx.set_gso(true)) std::cerr << "[Tx] UDP GSO unavailable, sending chunks individually" << std::endl;
+            if (!tx.set_fec(fec_data, fec_parity)) {
+                std::cerr << "[Tx] Invalid --fec " << fec_data << " " << fec_parity << " (need k >= 1, m >= 0, k + m <= 256)" << std::endl;
+                return 1;
+            }
+        }
+        RecordingWriter recorder;
+        if (!record_path.empty() && !recorder.open(record_path, true)) return 1;
+        uint64_t written = 0;
+        FrameSink sink = [&](const std::vector<uint8_t>& archive) {
+            if (!record_path.empty()) recorder.append(archive);
+            if (mode_tx) {
+                tx.send_frame(archive, tx_ip, tx_port);
+            } else if (record_path.empty()) {
+                std::ofstream out("stream_" + std::to_string(written++) + ".qsr", std::ios::binary);
+                out.write((const char*)archive.data(), archive.size());
+            }
+        };
+
+        StreamEncoder encoder(config);
+        StreamStats stats = encoder.run(source, sink);
+        if (!record_path.empty()) {
+            const size_t archives = recorder.frames();
+            if (!recorder.close()) return 1;
+            std::cout << "[Stream] Recording " << record_path << " holds " << archives << " archives" << std::endl;
+        }
+
+        std::cout << "[Stream] " << stats.frames << " frames in " << std::fixed << std::setprecision(2) << stats.seconds
+                  << " s (" << stats.fps() << " fps)" << std::endl;
+        const uint64_t dropped = from_ring ? ring.dropped() : raw.dropped();
+        if (dropped) std::cout << "[Stream] " << dropped << " frames dropped by the capture process" << std::endl;
+        std::cout << std::setw(12) << "stage" << std::setw(12) << "mean us" << std::setw(12) << "p50 us"
+                  << std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::endl;
+        auto row = [](const char* name, const LatencyHistogram& h) {
+            std::cout << std::setw(12) << name << std::setprecision(0) << std::setw(12) << h.meanMicros()
+                      << std::setw(12) << h.percentileMicros(50) << std::setw(12) << h.percentileMicros(99)
+                      << std::setw(12) << h.maxMicros() << std::endl;
+        };
+        for (int s = 0; s < StreamStats::kStages; ++s) row(StreamStats::stageName(s), stats.stage[s]);
+        row("end-to-end", stats.endToEnd);
         return 0;
     }
 
@@ -177,17 +519,19 @@ int main(int argc, char* argv[]) {
     // =========================================================================
     if (!mode_unpack) {
         std::vector<uint8_t> finalData;
+        std::vector<std::vector<uint8_t>> layerData; // Progressive Tx: one payload per layer
         uint8_t compressionFlags = 0;
         uint64_t originalSize = 0;
-        uint16_t width = 0, height = 0;
+        uint16_t width = 0, height = 0, max_value = 0;
 
         // 1. Pipeline Selection
-        if (fs::path(arg1).extension() == ".pgm") {
+        if (fs::path(arg1).extension() == ".pgm" || fs::path(arg1).extension() == ".ppm") {
             std::cout << "[Vision] Processing PGM with Multi-ROI Support..." << std::endl;
             GrayImage img(0, 0);
             if (!loadPGM(arg1, img)) return 1;
             originalSize = img.width * img.height;
             width = img.width; height = img.height;
+            max_value = static_cast<uint16_t>(img.maxVal);
             
             // Fallback to center if no ROI provided
             if (mission_targets.empty()) {
@@ -195,12 +539,42 @@ int main(int argc, char* argv[]) {
                 std::cout << " -> No ROI specified. Using center fallback." << std::endl;
             }
 
-            applySaliency(img, mission_targets); // Mask the pixels first
-            transform2D(img); 
-            std::vector<uint8_t> quantized = quantize(img, scale);
-            HuffmanCodec codec;
-            finalData = codec.compress(quantized);
-            compressionFlags |= 0x02; 
+            wavelet_levels = std::clamp(wavelet_levels, 1, std::max(1, maxWaveletLevels(width, height)));
+            if (coeff_coding && tile_size > 0 && !(progressive && mode_tx)) {
+                // Tiles are transformed, masked, quantized and coded in parallel
+                TileCoding coding;
+                coding.tileSize = std::clamp(tile_size, 16, 65535);
+                coding.levels = wavelet_levels;
+                coding.scale = scale;
+                coding.detailScale = detail_scale;
+                coding.falloff = roi_falloff;
+                finalData = encodeTiles(img, mission_targets, coding);
+                TileIndex index;
+                readTileIndex(finalData, width, height, index);
+                std::cout << " -> Tiled: " << index.tiles.size() << " tiles of " << index.tileSize << " px, "
+                          << index.skipped() << " outside every ROI skipped (" << defaultThreadPool().size() << " threads)" << std::endl;
+                compressionFlags |= 0x02 | 0x04 | 0x08;
+            } else {
+                transform2D(img, wavelet_levels);
+                applySubbandSaliency(img, mission_targets, wavelet_levels, roi_falloff); // Mask per subband
+                if (coeff_coding) {
+                    CoefficientCodec codec;
+                    std::vector<int32_t> coeffs = quantizeCoefficients(img, scale, detail_scale, wavelet_levels);
+                    if (progressive && mode_tx) {
+                        for (const ProgressiveLayer& layer : progressiveLayers(wavelet_levels)) {
+                            layerData.push_back(codec.encodeBands(coeffs, width, height, wavelet_levels, layer.firstBand, layer.bandCount));
+                        }
+                    } else {
+                        finalData = codec.encode(coeffs, width, height, wavelet_levels);
+                    }
+                    compressionFlags |= 0x04;
+                } else {
+                    std::vector<uint8_t> quantized = quantize(img, scale, detail_scale, wavelet_levels);
+                    HuffmanCodec codec;
+                    finalData = codec.compress(quantized);
+                }
+                compressionFlags |= 0x02;
+            }
         } else {
             std::cout << "[Binary] Processing generic archive..." << std::endl;
             std::ifstream inputFile(arg1, std::ios::binary | std::ios::ate);
@@ -224,6 +598,13 @@ int main(int argc, char* argv[]) {
         header.width = width; header.height = height;
         header.est_x = est_x; header.est_y = est_y; header.est_z = est_z;
         header.target_id = target_id;
+        header.wavelet_levels = (uint8_t)(compressionFlags & 0x02 ? wavelet_levels : 0);
+        header.format_version = kQuasarFormatVersion;
+        header.detail_scale = detail_scale;
+        if (layerData.empty()) layerData.push_back(std::move(finalData));
+        else std::cout << "[Vision] Progressive: " << layerData.size() << " layers, coarsest first" << std::endl;
+        header.layer_count = static_cast<uint8_t>(layerData.size());
+        header.max_value = max_value;
 
         // Populate Header Targets (ISRO SPEC)
         header.roi_count = (uint8_t)std::min((int)mission_targets.size(), 8);
@@ -231,75 +612,182 @@ int main(int argc, char* argv[]) {
             header.targets[k] = mission_targets[k];
         }
 
-        // 3. Security Layer (ChaCha20)
+        // 3. Security Layer (ChaCha20-Poly1305)
+        uint8_t key[32];
+        std::random_device rd;
+        header.sequence = rd();
         if (do_encrypt) {
-            uint8_t key[32], nonce[12];
-            std::random_device rd;
             if (!manual_key.empty()) parse_hex_key(manual_key, key);
             else { 
                 for (auto& k : key) k = rd() & 0xFF; 
                 std::cout << "[Security] Encrypting stream..." << std::endl;
                 print_hex("Generated PSK", key, 32);
             }
-            for (auto& n : nonce) n = rd() & 0xFF;
-            std::memcpy(header.nonce, nonce, 12);
             header.compression_flags |= 0x80; 
-            ChaCha20::process(finalData, key, nonce);
         }
 
-        // 4. Packet Combination
-        std::vector<uint8_t> fullArchive(sizeof(header) + finalData.size());
-        std::memcpy(fullArchive.data(), &header, sizeof(header));
-        std::memcpy(fullArchive.data() + sizeof(header), finalData.data(), finalData.size());
-
-        // 5. TX vs Disk Output
+        // 4. Packet Combination: one archive per layer, each with its own nonce.
+        // The layer payload is encrypted in place and the tag kept apart, so
+        // disk output can gather header, payload and tag without an archive copy.
+        auto seal_layer = [&](uint8_t layer, uint8_t tag[ChaCha20Poly1305::kTagSize]) {
+            QuasarHeader h = header;
+            h.layer = layer;
+            if (do_encrypt) {
+                for (auto& n : h.nonce) n = rd() & 0xFF;
+                ChaCha20Poly1305::seal(layerData[layer], std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&h), sizeof(h)),
+                                       key, h.nonce, tag);
+            }
+            return h;
+        };
+        const size_t tagSize = do_encrypt ? ChaCha20Poly1305::kTagSize : 0;
+
+        // 5. TX vs Disk Output (--record: appended to a flight recording as well
+        // as sent, or instead of an archive file)
+        RecordingWriter recorder;
+        if (!record_path.empty() && !recorder.open(record_path, true)) return 1;
         if (mode_tx) {
-            std::cout << "[Tx] Blasting " << fullArchive.size() << " bytes to " << tx_ip << ":" << tx_port << std::endl;
             QuasarTx tx;
-            tx.send_frame(fullArchive, tx_ip, tx_port);
+            tx.set_pacing(static_cast<uint64_t>(std::max(0.0, tx_rate_mbps) * 1e6));
+            if (tx_gso && !tx.set_gso(true)) std::cerr << "[Tx] UDP GSO unavailable, sending chunks individually" << std::endl;
+            if (!tx.set_fec(fec_data, fec_parity)) {
+                std::cerr << "[Tx] Invalid --fec " << fec_data << " " << fec_parity << " (need k >= 1, m >= 0, k + m <= 256)" << std::endl;
+                return 1;
+            }
+            for (size_t layer = 0; layer < layerData.size(); ++layer) {
+                uint8_t tag[ChaCha20Poly1305::kTagSize];
+                const QuasarHeader h = seal_layer(static_cast<uint8_t>(layer), tag);
+                // Header, payload and tag go out as one frame without being joined first
+                const std::span<const uint8_t> headerBytes(reinterpret_cast<const uint8_t*>(&h), sizeof(h));
+                const std::span<const uint8_t> tagBytes(tag, tagSize);
+                const std::vector<uint8_t>& data = layerData[layer];
+                std::cout << "[Tx] Blasting " << sizeof(h) + data.size() + tagSize << " bytes to " << tx_ip << ":" << tx_port << std::endl;
+                tx.send_frame(headerBytes, data, tagBytes, tx_ip, tx_port);
+                if (!record_path.empty()) recorder.append(h, data, tagBytes);
+            }
         } else {
-            std::string outputPath = arg1 + ".qsr";
-            std::ofstream out(outputPath, std::ios::binary);
-            out.write((const char*)fullArchive.data(), fullArchive.size());
-            std::cout << "[Disk] Saved archive to: " << outputPath << std::endl;
+            uint8_t tag[ChaCha20Poly1305::kTagSize];
+            const QuasarHeader h = seal_layer(0, tag);
+            const std::span<const uint8_t> tagBytes(tag, tagSize);
+            if (!record_path.empty()) {
+                if (!recorder.append(h, layerData[0], tagBytes)) return 1;
+                std::cout << "[Disk] Appended archive " << recorder.frames() << " to recording: " << record_path << std::endl;
+            } else {
+                std::string outputPath = arg1 + ".qsr";
+                if (!writeArchive(outputPath, h, layerData[0], tagBytes)) return 1;
+                std::cout << "[Disk] Saved archive to: " << outputPath << std::endl;
+            }
         }
+        if (!recorder.close()) return 1;
     } 
 
     // =========================================================================
     //                          UNPACK MODE (Disk Utility)
     // =========================================================================
     else {
-        std::cout << "[Unpack] Reading local archive " << arg1 << "..." << std::endl;
-        std::ifstream in(arg1, std::ios::binary);
-        if (!in) { std::cerr << "File Error." << std::endl; return 1; }
-
-        QuasarHeader header;
-        in.read((char*)&header, sizeof(header));
-        if (std::strncmp(header.magic, "QSR1", 4) != 0) { std::cerr << "Magic mismatch." << std::endl; return 1; }
-
-        std::vector<uint8_t> payload((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        uint8_t key[32];
+        bool have_key = false;
+        // Checks the version and authenticates + decrypts in place; on success
+        // `payload` is the plaintext
+        auto open_archive = [&](const ArchiveView& archive, std::span<uint8_t>& payload) {
+            const QuasarHeader& header = archive.header;
+            if (header.format_version != kQuasarFormatVersion) {
+                std::cerr << "Unsupported format version " << (int)header.format_version << " (expected " << (int)kQuasarFormatVersion << ")." << std::endl;
+                return false;
+            }
+            payload = archive.payload();
+            if (!(header.compression_flags & 0x80)) return true;
+            if (!have_key) {
+                if (!manual_key.empty()) parse_hex_key(manual_key, key);
+                else { std::cout << "Encrypted. Enter PSK: "; std::string s; std::cin >> s; parse_hex_key(s, key); }
+                have_key = true;
+            }
+            if (!open_payload(archive.headerBytes().data(), payload, key, header.nonce)) {
+                std::cerr << "Authentication failed (wrong key or corrupted archive)." << std::endl;
+                return false;
+            }
+            return true;
+        };
+        auto save = [&](const QuasarHeader& header, const GrayImage& img, const std::vector<uint8_t>& bytes, const std::string& base) {
+            if (header.compression_flags & 0x02) {
+                savePGM(base + ".recovered.pgm", img);
+                std::cout << "[Unpack] Reconstructed image: " << base << ".recovered.pgm" << std::endl;
+            } else {
+                std::ofstream out(base + ".recovered", std::ios::binary);
+                out.write((const char*)bytes.data(), bytes.size());
+                std::cout << "[Unpack] Reconstructed binary: " << base << ".recovered" << std::endl;
+            }
+        };
+
+        // --- Flight recording: every archive (or one image) out of the index ---
+        if (fs::path(arg1).extension() == ".qsrm") {
+            RecordingReader recording;
+            if (!recording.open(arg1)) return 1;
+            std::cout << "[Unpack] Recording " << arg1 << ": " << recording.size() << " archives"
+                      << (recording.recovered() ? " (not closed; index rebuilt)" : "") << std::endl;
+
+            std::vector<size_t> selected;
+            if (has_frame) selected = recording.findSequence(only_frame);
+            else for (size_t i = 0; i < recording.size(); ++i) selected.push_back(i);
+
+            if (list_only) {
+                const uint64_t t0 = recording.size() ? recording.index().front().timestamp_us : 0;
+                std::cout << std::setw(8) << "#" << std::setw(12) << "t (s)" << std::setw(12) << "sequence" << std::setw(8) << "layer"
+                          << std::setw(10) << "bytes" << "  pose" << std::endl;
+                for (size_t i : selected) {
+                    const RecordingEntry& e = recording.index()[i];
+                    std::cout << std::setw(8) << i << std::setw(12) << std::fixed << std::setprecision(3) << (e.timestamp_us - t0) / 1e6
+                              << std::setw(12) << e.sequence << std::setw(5) << (int)e.layer + 1 << "/" << std::left << std::setw(2)
+                              << (int)std::max<uint8_t>(1, e.layer_count) << std::right << std::setw(10) << e.size << "  ("
+                              << e.est_x << ", " << e.est_y << ", " << e.est_z << ")" << std::endl;
+                }
+                return 0;
+            }
 
-        if (header.compression_flags & 0x80) {
-            uint8_t key[32];
-            if (!manual_key.empty()) parse_hex_key(manual_key, key);
-            else { std::cout << "Encrypted. Enter PSK: "; std::string s; std::cin >> s; parse_hex_key(s, key); }
-            ChaCha20::process(payload, key, header.nonce);
+            // Outputs are named by index entry (sequence numbers restart with
+            // every --stream run); the layers of a progressive image refine the
+            // file named after its first layer
+            struct Layered {
+                ProgressiveDecoder decoder;
+                size_t first;
+            };
+            std::map<uint32_t, Layered> layered;
+            int failed = 0;
+            for (size_t i : selected) {
+                ArchiveView archive;
+                std::span<uint8_t> payload;
+                if (!recording.archive(i, archive) || !open_archive(archive, payload)) { failed++; continue; }
+                const QuasarHeader& header = archive.header;
+                std::string base = arg1 + "." + std::to_string(i);
+                GrayImage img(0, 0);
+                std::vector<uint8_t> decompressed;
+                if ((header.compression_flags & 0x04) && header.layer_count > 1) {
+                    Layered& image = layered.try_emplace(header.sequence, Layered{{}, i}).first->second;
+                    if (!image.decoder.addLayer(header, payload)) { std::cerr << "Corrupt layer in archive " << i << "." << std::endl; failed++; continue; }
+                    image.decoder.render(img);
+                    base = arg1 + "." + std::to_string(image.first);
+                } else if (!decode_payload(header, payload, img, decompressed)) {
+                    std::cerr << "Corrupt payload in archive " << i << "." << std::endl;
+                    failed++;
+                    continue;
+                }
+                save(header, img, decompressed, base);
+            }
+            if (failed) std::cerr << "[Unpack] " << failed << " of " << selected.size() << " archives could not be restored." << std::endl;
+            return failed ? 1 : 0;
         }
 
-        HuffmanCodec codec;
-        std::vector<uint8_t> decompressed = codec.decompress(payload);
+        std::cout << "[Unpack] Reading local archive " << arg1 << "..." << std::endl;
+        MappedArchive archive;
+        if (!archive.open(arg1)) return 1;
 
-        if (header.compression_flags & 0x02) {
-            GrayImage img(header.width, header.height);
-            dequantize(decompressed, img, header.scale);
-            inverseTransform2D(img);
-            savePGM(arg1 + ".recovered.pgm", img);
-            std::cout << "[Unpack] Reconstructed image: " << arg1 << ".recovered.pgm" << std::endl;
-        } else {
-            std::ofstream out(arg1 + ".recovered", std::ios::binary);
-            out.write((const char*)decompressed.data(), decompressed.size());
-            std::cout << "[Unpack] Reconstructed binary: " << arg1 << ".recovered" << std::endl;
-        }
+        // A view into the (private) mapping: decrypted and decoded in place
+        std::span<uint8_t> payload;
+        if (!open_archive(archive.view(), payload)) return 1;
+
+        GrayImage img(0, 0);
+        std::vector<uint8_t> decompressed;
+        if (!decode_payload(archive.header(), payload, img, decompressed)) { std::cerr << "Corrupt payload." << std::endl; return 1; }
+        save(archive.header(), img, decompressed, arg1);
     }
 
     return 0;
@@ -0,0 +1,128 @@
+#include "mapped_file.h"
+#include <iostream>
+#include <cstring>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --- MappedFile ---
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    buffer.clear();
+#else
+    if (base) munmap(base, length);
+#endif
+    base = nullptr;
+    length = 0;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    base = buffer.data();
+    length = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Cannot stat " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {  // mmap rejects empty mappings
+        ::close(fd);
+        return true;
+    }
+    // Private + writable: in-place decryption copies the touched pages, the
+    // file stays as it is
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (p == MAP_FAILED) {
+        std::cerr << "Cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    base = static_cast<uint8_t*>(p);
+    length = static_cast<size_t>(st.st_size);
+    madvise(base, length, MADV_SEQUENTIAL);  // Readers walk the file front to back
+#endif
+    return true;
+}
+
+// --- MappedOutput ---
+
+bool MappedOutput::create(const std::string& target, size_t size) {
+    close();
+    path = target;
+#ifdef _WIN32
+    buffer.assign(size, 0);
+    base = buffer.data();
+    length = size;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot create " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(size));
+    if (err != 0) {
+        std::cerr << "Cannot allocate " << size << " bytes for " << path << ": " << std::strerror(err) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "Cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    base = static_cast<uint8_t*>(p);
+    length = size;
+#endif
+    return true;
+}
+
+bool MappedOutput::close() {
+    bool ok = true;
+#ifdef _WIN32
+    if (base) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        ok = static_cast<bool>(out);
+    }
+    buffer.clear();
+#else
+    // The kernel writes the dirty pages back; munmap itself cannot lose them
+    if (base) ok = munmap(base, length) == 0;
+#endif
+    if (!ok) std::cerr << "Writing " << path << " failed" << std::endl;
+    base = nullptr;
+    length = 0;
+    return ok;
+}
@@ -0,0 +1,68 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A whole file mapped into memory, private and writable: writes (such as
+ * in-place decryption) copy the touched pages and never reach the file.
+ * Where mmap is not available the file is read into memory once instead.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false (with a message on stderr) if `path` cannot be read
+    bool open(const std::string& path);
+    void close();
+
+    std::span<uint8_t> bytes() const { return {base, length}; }
+
+private:
+    uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+/**
+ * A new file of known size written through a shared mapping, so its contents
+ * are produced straight into the page cache: no staging buffer and no copy
+ * through write(). The space is allocated up front, so a full disk is an
+ * error from create() rather than a fault on a later store. Where mmap is not
+ * available the bytes are buffered and written by close().
+ */
+class MappedOutput {
+public:
+    MappedOutput() = default;
+    ~MappedOutput() { close(); }
+
+    MappedOutput(const MappedOutput&) = delete;
+    MappedOutput& operator=(const MappedOutput&) = delete;
+
+    // Creates (or truncates) `path` with `size` bytes; false with a message
+    // on stderr if it cannot
+    bool create(const std::string& path, size_t size);
+    std::span<uint8_t> bytes() const { return {base, length}; }
+    // Unmaps (or writes) the file; false if it could not be written
+    bool close();
+
+private:
+    std::string path;
+    uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+#endif // MAPPED_FILE_H
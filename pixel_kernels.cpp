@@ -0,0 +1,214 @@
+#include "pixel_kernels.h"
+#include "cpu_features.h"
+#include <cmath>
+
+#if defined(QUASAR_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON)
+#include <arm_neon.h>
+#endif
+
+// --- Scalar reference ---
+
+// Written as compares so NaN lands on 0, like the SIMD paths
+static inline float clampSample(float v, float hi) {
+    v = v > 0.0f ? v : 0.0f;
+    return v < hi ? v : hi;
+}
+
+static void u8ToFloatScalar(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(src[i]);
+}
+
+static void u16ToFloatScalar(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>((src[2 * i] << 8) | src[2 * i + 1]);
+}
+
+static void u16leToFloatScalar(const uint8_t* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(src[2 * i] | (src[2 * i + 1] << 8));
+}
+
+static void floatToU8Scalar(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    for (size_t i = 0; i < n; ++i) dst[i] = static_cast<uint8_t>(std::nearbyint(clampSample(src[i], maxVal)));
+}
+
+static void floatToU16Scalar(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t v = static_cast<uint16_t>(std::nearbyint(clampSample(src[i], maxVal)));
+        dst[2 * i] = static_cast<uint8_t>(v >> 8);
+        dst[2 * i + 1] = static_cast<uint8_t>(v);
+    }
+}
+
+// --- AVX2 ---
+
+#if defined(QUASAR_X86)
+// Swaps the bytes of every 16-bit lane (big-endian samples <-> native)
+QUASAR_TARGET_AVX2
+static inline __m128i byteSwapMask128() {
+    return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+}
+
+QUASAR_TARGET_AVX2
+static void u8ToFloatAVX2(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(b)));
+    }
+    u8ToFloatScalar(src + i, dst + i, n - i);
+}
+
+QUASAR_TARGET_AVX2
+static void u16ToFloatAVX2(const uint8_t* src, float* dst, size_t n) {
+    const __m128i swap = byteSwapMask128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i)), swap);
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(s)));
+    }
+    u16ToFloatScalar(src + 2 * i, dst + i, n - i);
+}
+
+QUASAR_TARGET_AVX2
+static void u16leToFloatAVX2(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(s)));
+    }
+    u16leToFloatScalar(src + 2 * i, dst + i, n - i);
+}
+
+// cvtps_epi32 rounds with MXCSR (round-to-nearest-even by default), which is
+// what std::nearbyint does in the scalar path. max_ps returns its second
+// operand for NaN, so the lower clamp also maps NaN to 0.
+QUASAR_TARGET_AVX2
+static inline __m256i clampRound(const float* src, __m256 hi) {
+    __m256 v = _mm256_max_ps(_mm256_loadu_ps(src), _mm256_setzero_ps());
+    return _mm256_cvtps_epi32(_mm256_min_ps(v, hi));
+}
+
+QUASAR_TARGET_AVX2
+static void floatToU8AVX2(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    const __m256 hi = _mm256_set1_ps(maxVal);
+    // Packs interleave the 128-bit lanes; this restores sample order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i ab = _mm256_packus_epi32(clampRound(src + i, hi), clampRound(src + i + 8, hi));
+        __m256i cd = _mm256_packus_epi32(clampRound(src + i + 16, hi), clampRound(src + i + 24, hi));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+    }
+    floatToU8Scalar(src + i, dst + i, n - i, maxVal);
+}
+
+QUASAR_TARGET_AVX2
+static void floatToU16AVX2(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    const __m256 hi = _mm256_set1_ps(maxVal);
+    const __m256i swap = _mm256_broadcastsi128_si256(byteSwapMask128());
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i words = _mm256_packus_epi32(clampRound(src + i, hi), clampRound(src + i + 8, hi));
+        words = _mm256_permute4x64_epi64(words, 0xD8);  // Undo the per-lane interleave
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_shuffle_epi8(words, swap));
+    }
+    floatToU16Scalar(src + i, dst + 2 * i, n - i, maxVal);
+}
+#endif
+
+// --- NEON ---
+
+#if defined(QUASAR_NEON)
+static void u8ToFloatNEON(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t b = vld1q_u8(src + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(b)), hi = vmovl_u8(vget_high_u8(b));
+        vst1q_f32(dst + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))));
+        vst1q_f32(dst + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))));
+        vst1q_f32(dst + i + 8, vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))));
+        vst1q_f32(dst + i + 12, vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))));
+    }
+    u8ToFloatScalar(src + i, dst + i, n - i);
+}
+
+static void u16ToFloatNEON(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t s = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(src + 2 * i)));
+        vst1q_f32(dst + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(s))));
+        vst1q_f32(dst + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(s))));
+    }
+    u16ToFloatScalar(src + 2 * i, dst + i, n - i);
+}
+
+static void u16leToFloatNEON(const uint8_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t s = vreinterpretq_u16_u8(vld1q_u8(src + 2 * i));
+        vst1q_f32(dst + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(s))));
+        vst1q_f32(dst + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(s))));
+    }
+    u16leToFloatScalar(src + 2 * i, dst + i, n - i);
+}
+
+// Selecting on an ordered compare sends NaN to 0; vcvtnq rounds ties to even
+static inline uint32x4_t clampRoundNEON(const float* src, float32x4_t hi) {
+    float32x4_t v = vld1q_f32(src);
+    v = vbslq_f32(vcgtq_f32(v, vdupq_n_f32(0.0f)), v, vdupq_n_f32(0.0f));
+    return vcvtnq_u32_f32(vminq_f32(v, hi));
+}
+
+static void floatToU8NEON(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    const float32x4_t hi = vdupq_n_f32(maxVal);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x8_t lo = vcombine_u16(vqmovn_u32(clampRoundNEON(src + i, hi)), vqmovn_u32(clampRoundNEON(src + i + 4, hi)));
+        uint16x8_t up = vcombine_u16(vqmovn_u32(clampRoundNEON(src + i + 8, hi)), vqmovn_u32(clampRoundNEON(src + i + 12, hi)));
+        vst1q_u8(dst + i, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(up)));
+    }
+    floatToU8Scalar(src + i, dst + i, n - i, maxVal);
+}
+
+static void floatToU16NEON(const float* src, uint8_t* dst, size_t n, float maxVal) {
+    const float32x4_t hi = vdupq_n_f32(maxVal);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t words = vcombine_u16(vqmovn_u32(clampRoundNEON(src + i, hi)), vqmovn_u32(clampRoundNEON(src + i + 4, hi)));
+        vst1q_u8(dst + 2 * i, vrev16q_u8(vreinterpretq_u8_u16(words)));
+    }
+    floatToU16Scalar(src + i, dst + 2 * i, n - i, maxVal);
+}
+#endif
+
+// --- Dispatch ---
+
+const PixelKernels& pixelScalarKernels() {
+    static const PixelKernels k = {"scalar", u8ToFloatScalar, u16ToFloatScalar, u16leToFloatScalar, floatToU8Scalar, floatToU16Scalar};
+    return k;
+}
+
+static const PixelKernels& selectKernels() {
+#if defined(QUASAR_X86)
+    if (cpuFeatures().avx2) {
+        static const PixelKernels k = {"avx2", u8ToFloatAVX2, u16ToFloatAVX2, u16leToFloatAVX2, floatToU8AVX2, floatToU16AVX2};
+        return k;
+    }
+#endif
+#if defined(QUASAR_NEON)
+    if (cpuFeatures().neon) {
+        static const PixelKernels k = {"neon", u8ToFloatNEON, u16ToFloatNEON, u16leToFloatNEON, floatToU8NEON, floatToU16NEON};
+        return k;
+    }
+#endif
+    return pixelScalarKernels();
+}
+
+const PixelKernels& pixelKernels() {
+    static const PixelKernels& k = selectKernels();
+    return k;
+}
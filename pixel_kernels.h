@@ -0,0 +1,38 @@
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Sample conversion kernels for PGM/PPM and raw frame I/O. 16-bit samples are
+// big-endian, as PGM stores them, except for u16leToFloat (camera buffers).
+// Like the quantization kernels, every implementation is bit-identical: float
+// samples are clamped to [0, max] (NaN becomes 0) and rounded half to even
+// (the SIMD conversion mode).
+struct PixelKernels {
+    const char* name;
+
+    // dst[i] = src[i]
+    void (*u8ToFloat)(const uint8_t* src, float* dst, size_t n);
+
+    // dst[i] = 16-bit sample i of src (2n bytes)
+    void (*u16ToFloat)(const uint8_t* src, float* dst, size_t n);
+
+    // The same for little-endian samples
+    void (*u16leToFloat)(const uint8_t* src, float* dst, size_t n);
+
+    // dst[i] = round(clamp(src[i], 0, maxVal)), maxVal <= 255
+    void (*floatToU8)(const float* src, uint8_t* dst, size_t n, float maxVal);
+
+    // 16-bit sample i of dst (2n bytes) = round(clamp(src[i], 0, maxVal)),
+    // maxVal <= 65535
+    void (*floatToU16)(const float* src, uint8_t* dst, size_t n, float maxVal);
+};
+
+// Portable reference kernels
+const PixelKernels& pixelScalarKernels();
+
+// Best kernels for the running CPU (selected once via cpuFeatures())
+const PixelKernels& pixelKernels();
+
+#endif // PIXEL_KERNELS_H
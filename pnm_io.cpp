@@ -0,0 +1,179 @@
+#include "pnm_io.h"
+#include "pixel_kernels.h"
+#include "mapped_file.h"
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct PnmHeader {
+    int kind = 0;     // 2, 3, 5 or 6 (the digit after 'P')
+    int width = 0;
+    int height = 0;
+    int maxVal = 0;
+
+    bool binary() const { return kind >= 5; }
+    int channels() const { return kind == 3 || kind == 6 ? 3 : 1; }
+    size_t bytesPerSample() const { return maxVal > 255 ? 2 : 1; }
+    size_t samples() const { return static_cast<size_t>(width) * height * channels(); }
+};
+
+// Byte sources for the parser; get() and peek() return -1 at the end
+struct MemorySource {
+    const uint8_t* p;
+    const uint8_t* end;
+    int peek() const { return p < end ? *p : -1; }
+    int get() { return p < end ? *p++ : -1; }
+};
+
+struct StreamSource {
+    std::istream& in;
+    int peek() { return in.peek(); }
+    int get() { return in.get(); }
+};
+
+static_assert(std::char_traits<char>::eof() == -1);
+
+// Next decimal number, after any whitespace and '#' comments. The character
+// that ends it is left unread.
+template <typename Source>
+bool readNumber(Source& src, int& value) {
+    for (int c = src.peek();; c = src.peek()) {
+        if (c == '#') {
+            while (c != '\n' && c != '\r' && c != -1) c = src.get();
+        } else if (c != -1 && std::isspace(c)) {
+            src.get();
+        } else {
+            break;
+        }
+    }
+    if (src.peek() < '0' || src.peek() > '9') return false;
+    int v = 0;
+    while (src.peek() >= '0' && src.peek() <= '9') {
+        v = v * 10 + (src.get() - '0');
+        if (v > 65535) return false;  // Larger than any valid dimension or sample
+    }
+    value = v;
+    return true;
+}
+
+template <typename Source>
+bool readHeader(Source& src, PnmHeader& h) {
+    // Whitespace between images in a stream (an ASCII raster's last newline)
+    while (src.peek() != -1 && std::isspace(src.peek())) src.get();
+    if (src.get() != 'P') return false;
+    h.kind = src.get() - '0';
+    if (h.kind != 2 && h.kind != 3 && h.kind != 5 && h.kind != 6) return false;
+    if (!readNumber(src, h.width) || !readNumber(src, h.height) || !readNumber(src, h.maxVal)) return false;
+    if (h.width <= 0 || h.height <= 0 || h.maxVal <= 0) return false;
+    if (!h.binary()) return true;  // ASCII samples skip their own separators
+    // Exactly one whitespace character separates maxval from a binary raster
+    int c = src.get();
+    return c != -1 && std::isspace(c);
+}
+
+void resize(GrayImage& img, const PnmHeader& h) {
+    // Reuses img.data's storage when the size does not change
+    img.width = h.width;
+    img.height = h.height;
+    img.maxVal = h.maxVal;
+    img.data.resize(static_cast<size_t>(h.width) * h.height);
+}
+
+// BT.601 luma of interleaved RGB samples
+void toLuma(const float* rgb, float* gray, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        gray[i] = 0.299f * rgb[3 * i] + 0.587f * rgb[3 * i + 1] + 0.114f * rgb[3 * i + 2];
+    }
+}
+
+// Converts a binary raster (header.samples() samples at `raster`) into img
+void convertRaster(const PnmHeader& h, const uint8_t* raster, GrayImage& img) {
+    const PixelKernels& k = pixelKernels();
+    auto convert = h.bytesPerSample() == 2 ? k.u16ToFloat : k.u8ToFloat;
+    resize(img, h);
+    if (h.channels() == 1) {
+        convert(raster, img.data.data(), img.data.size());
+        return;
+    }
+    thread_local std::vector<float> rgb;
+    rgb.resize(h.samples());
+    convert(raster, rgb.data(), rgb.size());
+    toLuma(rgb.data(), img.data.data(), img.data.size());
+}
+
+template <typename Source>
+bool readAsciiRaster(Source& src, const PnmHeader& h, GrayImage& img) {
+    resize(img, h);
+    float rgb[3];
+    for (float& pixel : img.data) {
+        for (int c = 0; c < h.channels(); ++c) {
+            int v = 0;
+            if (!readNumber(src, v) || v > h.maxVal) return false;
+            rgb[c] = static_cast<float>(v);
+        }
+        if (h.channels() == 1) {
+            pixel = rgb[0];
+        } else {
+            toLuma(rgb, &pixel, 1);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool loadPGM(const std::string& path, GrayImage& img) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    std::span<uint8_t> bytes = file.bytes();
+    MemorySource src{bytes.data(), bytes.data() + bytes.size()};
+    PnmHeader h;
+    bool ok = readHeader(src, h);
+    if (ok && h.binary()) {
+        ok = static_cast<size_t>(src.end - src.p) >= h.samples() * h.bytesPerSample();
+        if (ok) convertRaster(h, src.p, img);
+    } else if (ok) {
+        ok = readAsciiRaster(src, h, img);
+    }
+    if (!ok) std::cerr << "Not a valid PGM/PPM image: " << path << std::endl;
+    return ok;
+}
+
+bool readPGM(std::istream& in, GrayImage& img) {
+    StreamSource src{in};
+    PnmHeader h;
+    if (!readHeader(src, h)) return false;
+    if (!h.binary()) return readAsciiRaster(src, h, img);
+
+    // The raster is read in one call into a buffer kept across frames
+    thread_local std::vector<uint8_t> buffer;
+    buffer.resize(h.samples() * h.bytesPerSample());
+    if (!in.read(reinterpret_cast<char*>(buffer.data()), buffer.size())) return false;
+    convertRaster(h, buffer.data(), img);
+    return true;
+}
+
+bool savePGM(const std::string& path, const GrayImage& img) {
+    const int maxVal = std::clamp(img.maxVal, 1, 65535);
+    const std::string header =
+        "P5\n" + std::to_string(img.width) + " " + std::to_string(img.height) + "\n" + std::to_string(maxVal) + "\n";
+    const size_t n = img.data.size();
+    const size_t bytesPerSample = maxVal > 255 ? 2 : 1;
+
+    // Samples are converted straight into the mapped file
+    MappedOutput out;
+    if (!out.create(path, header.size() + n * bytesPerSample)) return false;
+    uint8_t* dst = out.bytes().data();
+    std::memcpy(dst, header.data(), header.size());
+    const PixelKernels& k = pixelKernels();
+    if (bytesPerSample == 2) {
+        k.floatToU16(img.data.data(), dst + header.size(), n, static_cast<float>(maxVal));
+    } else {
+        k.floatToU8(img.data.data(), dst + header.size(), n, static_cast<float>(maxVal));
+    }
+    return out.close();
+}
@@ -0,0 +1,24 @@
+#ifndef PNM_IO_H
+#define PNM_IO_H
+
+#include <string>
+#include <istream>
+#include "wavelet.h"
+
+// Netpbm image I/O.
+//
+// Readers accept gray (P2 ASCII, P5 binary) and colour (P3, P6) images with
+// 8-bit or, when maxval > 255, 16-bit big-endian samples. Colour is reduced to
+// luma (BT.601 weights). Comments may appear anywhere in the header. Samples
+// keep their native range, and img.maxVal records the file's maxval.
+
+// Maps the file and converts the samples straight from the mapping
+bool loadPGM(const std::string& path, GrayImage& img);
+
+// Reads one image from a stream, e.g. the next frame of a FIFO
+bool readPGM(std::istream& in, GrayImage& img);
+
+// Writes a binary P5 with maxval img.maxVal (16-bit samples above 255)
+bool savePGM(const std::string& path, const GrayImage& img);
+
+#endif // PNM_IO_H
@@ -0,0 +1,63 @@
+#include "progressive.h"
+#include "coeff_codec.h"
+#include <algorithm>
+#include <bit>
+
+std::vector<ProgressiveLayer> progressiveLayers(int levels) {
+    // subbandLayout order: LL, then HL/LH/HH from the coarsest level down
+    levels = std::max(1, levels);
+    std::vector<ProgressiveLayer> layers;
+    layers.push_back({0, 4});
+    for (int l = 1; l < levels; ++l) layers.push_back({1 + 3 * l, 3});
+    return layers;
+}
+
+int ProgressiveDecoder::layersReceived() const {
+    return std::popcount(received);
+}
+
+bool ProgressiveDecoder::addLayer(const QuasarHeader& header, std::span<const uint8_t> payload) {
+    const int levels = std::max<int>(1, header.wavelet_levels);
+    const auto layers = progressiveLayers(levels);
+    if (!(header.compression_flags & 0x04) || header.layer_count != layers.size() || header.layer_count > 32 ||
+        header.layer >= header.layer_count) {
+        return false;
+    }
+    if (hasPrevious && header.sequence == previousSequence) return false;
+
+    if (!active || header.sequence != current.sequence) {
+        if (active) {
+            hasPrevious = true;
+            previousSequence = current.sequence;
+        }
+        active = true;
+        current = header;
+        received = 0;
+        coeffs.assign(static_cast<size_t>(header.width) * header.height, 0);
+    } else if (header.width != current.width || header.height != current.height ||
+               header.wavelet_levels != current.wavelet_levels || header.scale != current.scale ||
+               header.detail_scale != current.detail_scale || header.layer_count != current.layer_count) {
+        return false;
+    }
+    if (received & (1u << header.layer)) return false;
+
+    CoefficientCodec codec;
+    const ProgressiveLayer& layer = layers[header.layer];
+    if (!codec.decodeBands(payload, header.width, header.height, levels, layer.firstBand, layer.bandCount, coeffs)) {
+        // Clear whatever the bad layer left behind
+        std::vector<uint8_t> empty(layer.bandCount, 0);
+        codec.decodeBands(empty, header.width, header.height, levels, layer.firstBand, layer.bandCount, coeffs);
+        return false;
+    }
+    received |= 1u << header.layer;
+    return true;
+}
+
+void ProgressiveDecoder::render(GrayImage& img) const {
+    if (!active) return;
+    const int levels = std::max<int>(1, current.wavelet_levels);
+    img = GrayImage(current.width, current.height);
+    img.maxVal = current.max_value ? current.max_value : 255;
+    dequantizeCoefficients(coeffs, img, current.scale, current.detail_scale, levels);
+    inverseTransform2D(img, levels);
+}
@@ -0,0 +1,58 @@
+#ifndef PROGRESSIVE_H
+#define PROGRESSIVE_H
+
+#include <vector>
+#include <cstdint>
+#include <span>
+#include "quasar_format.h"
+#include "wavelet.h"
+
+/**
+ * Progressive (layered) transmission of coefficient-coded frames.
+ *
+ * An image transformed with L levels is split into L layers by
+ * decomposition level: layer 0 carries LL and the coarsest detail bands,
+ * every following layer the next finer level. Saliency masking has already
+ * zeroed the detail bands outside the ROIs, so the later layers carry
+ * mostly ROI detail.
+ *
+ * Each layer travels as its own archive (header with sequence/layer fields,
+ * the layer's bands, and its own tag when encrypted), so every layer is
+ * authenticated and decoded on arrival, in any order. The receiver renders
+ * a preview from whatever it has, with missing finer levels read as zero.
+ */
+struct ProgressiveLayer {
+    int firstBand;   // Index into subbandLayout() order
+    int bandCount;
+};
+
+// Layers of a `levels`-deep transform; a single layer for levels <= 1
+std::vector<ProgressiveLayer> progressiveLayers(int levels);
+
+// Receive side: accumulates the layers of the image being received.
+class ProgressiveDecoder {
+public:
+    // Adds one decrypted layer payload. A new sequence number starts a new
+    // image and abandons the previous one, whose late layers are then
+    // ignored. Returns false for stale, duplicate, inconsistent or corrupt
+    // layers.
+    bool addLayer(const QuasarHeader& header, std::span<const uint8_t> payload);
+
+    // Image reconstructed from the layers received so far
+    void render(GrayImage& img) const;
+
+    int layersReceived() const;
+    int layerCount() const { return active ? current.layer_count : 0; }
+    bool complete() const { return active && layersReceived() == current.layer_count; }
+    uint32_t sequence() const { return current.sequence; }
+
+private:
+    bool active = false;
+    QuasarHeader current{};
+    uint32_t received = 0;          // Bit per layer
+    bool hasPrevious = false;
+    uint32_t previousSequence = 0;
+    std::vector<int32_t> coeffs;    // Quantized plane, filled in layer by layer
+};
+
+#endif // PROGRESSIVE_H
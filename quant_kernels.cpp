@@ -0,0 +1,118 @@
+#include "quant_kernels.h"
+#include "cpu_features.h"
+#include <cmath>
+
+#if defined(QUASAR_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(QUASAR_NEON)
+#include <arm_neon.h>
+#endif
+
+// Saturation bounds: the largest floats whose conversion cannot overflow int32
+static constexpr float kQuantMax = 2147483520.0f;
+static constexpr float kQuantMin = -2147483520.0f;
+
+// --- Scalar reference ---
+
+static void quantizeScalar(const float* src, int32_t* dst, int n, float scale) {
+    for (int i = 0; i < n; ++i) {
+        float v = src[i] * scale;
+        // Written as compares so NaN lands on kQuantMin, like the SIMD paths
+        v = v > kQuantMin ? v : kQuantMin;
+        v = v < kQuantMax ? v : kQuantMax;
+        dst[i] = static_cast<int32_t>(std::nearbyint(v));
+    }
+}
+
+static void dequantizeScalar(const int32_t* src, float* dst, int n, float invScale) {
+    for (int i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]) * invScale;
+    }
+}
+
+// --- AVX2 ---
+
+#if defined(QUASAR_X86)
+// cvtps_epi32 rounds with MXCSR (round-to-nearest-even by default), which is
+// what std::nearbyint does in the scalar path.
+QUASAR_TARGET_AVX2
+static void quantizeAVX2(const float* src, int32_t* dst, int n, float scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 lo = _mm256_set1_ps(kQuantMin);
+    const __m256 hi = _mm256_set1_ps(kQuantMax);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i), s);
+        v = _mm256_min_ps(_mm256_max_ps(v, lo), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtps_epi32(v));
+    }
+    quantizeScalar(src + i, dst + i, n - i, scale);
+}
+
+QUASAR_TARGET_AVX2
+static void dequantizeAVX2(const int32_t* src, float* dst, int n, float invScale) {
+    const __m256 s = _mm256_set1_ps(invScale);
+    int i = 0;
+    for (; i <= n - 8; i += 8) {
+        __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(q), s));
+    }
+    dequantizeScalar(src + i, dst + i, n - i, invScale);
+}
+#endif
+
+// --- NEON ---
+
+#if defined(QUASAR_NEON)
+static void quantizeNEON(const float* src, int32_t* dst, int n, float scale) {
+    const float32x4_t lo = vdupq_n_f32(kQuantMin);
+    const float32x4_t hi = vdupq_n_f32(kQuantMax);
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        float32x4_t v = vmulq_n_f32(vld1q_f32(src + i), scale);
+        // vmaxq_f32 propagates NaN; selecting on an ordered compare sends it to lo
+        v = vbslq_f32(vcgtq_f32(v, lo), v, lo);
+        v = vbslq_f32(vcltq_f32(v, hi), v, hi);
+        vst1q_s32(dst + i, vcvtnq_s32_f32(v)); // round to nearest, ties to even
+    }
+    quantizeScalar(src + i, dst + i, n - i, scale);
+}
+
+static void dequantizeNEON(const int32_t* src, float* dst, int n, float invScale) {
+    int i = 0;
+    for (; i <= n - 4; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), invScale));
+    }
+    dequantizeScalar(src + i, dst + i, n - i, invScale);
+}
+#endif
+
+// --- Dispatch ---
+
+const QuantKernels& quantScalarKernels() {
+    static const QuantKernels k = {"scalar", quantizeScalar, dequantizeScalar};
+    return k;
+}
+
+static const QuantKernels& selectKernels() {
+#if defined(QUASAR_X86)
+    if (cpuFeatures().avx2) {
+        static const QuantKernels k = {"avx2", quantizeAVX2, dequantizeAVX2};
+        return k;
+    }
+#endif
+#if defined(QUASAR_NEON)
+    if (cpuFeatures().neon) {
+        static const QuantKernels k = {"neon", quantizeNEON, dequantizeNEON};
+        return k;
+    }
+#endif
+    return quantScalarKernels();
+}
+
+const QuantKernels& quantKernels() {
+    static const QuantKernels& k = selectKernels();
+    return k;
+}
@@ -0,0 +1,26 @@
+#ifndef QUANT_KERNELS_H
+#define QUANT_KERNELS_H
+
+#include <cstdint>
+
+// Quantization kernels used by wavelet.cpp. Like the Haar kernels, every
+// implementation is bit-identical: rounding is round-half-to-even (the SIMD
+// conversion mode), out-of-range values saturate to +/-2147483520 (the largest
+// float below 2^31) and NaN maps to the negative limit.
+struct QuantKernels {
+    const char* name;
+
+    // dst[i] = saturate(round(src[i] * scale))
+    void (*quantize)(const float* src, int32_t* dst, int n, float scale);
+
+    // dst[i] = src[i] * invScale (multiply by the reciprocal, no divide)
+    void (*dequantize)(const int32_t* src, float* dst, int n, float invScale);
+};
+
+// Portable reference kernels
+const QuantKernels& quantScalarKernels();
+
+// Best kernels for the running CPU (selected once via cpuFeatures())
+const QuantKernels& quantKernels();
+
+#endif // QUANT_KERNELS_H
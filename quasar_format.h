@@ -8,6 +8,21 @@
 // #pragma pack(push, 1) is used for MSVC compatibility if needed, 
 // but we will stick to the user's specific constraint first.
 
+// Payload format revision, bumped on every incompatible payload change.
+//   1: Huffman stream prefixed by a 256 x uint32 frequency table
+//   2: Huffman stream prefixed by a compact canonical code-length table
+//   3: Coefficient payload (0x04): quantized coefficients coded per subband
+//      as run/class symbols
+//   4: Per-subband quantization scales; quantize() bit-packs each subband
+//   5: Encrypted frames (0x80) use ChaCha20-Poly1305 with the header as
+//      associated data and a 16-byte tag after the ciphertext
+//   6: Header gains sequence/layer/layer_count; a progressive image is sent
+//      as one archive per layer, each carrying a range of subbands
+//   7: Tiled coefficient payload (0x08): tile index, then one independently
+//      transformed and coded stream per tile
+//   8: Header gains max_value, the source's sample range (16-bit sensors)
+constexpr uint8_t kQuasarFormatVersion = 8;
+
 #ifdef _MSC_VER
 #pragma pack(push, 1)
 #endif
@@ -26,7 +41,7 @@ QuasarHeader {
     char magic[4];          // 'Q', 'S', 'R', '1'
     uint8_t file_type;      // 0=Binary, 1=Text, 2=PGM, etc.
     uint64_t original_size; // Original file size in bytes
-    uint8_t compression_flags; // Bit 0: Huffman, Bit 1: Wavelet, Bit 7: Encrypted
+    uint8_t compression_flags; // Bit 0: Huffman, Bit 1: Wavelet, Bit 2: Coeff coder, Bit 3: Tiled, Bit 7: Encrypted
     uint8_t nonce[12];      // 96-bit Nonce for ChaCha20
     float scale;            // Quantization scale factor
     uint16_t width;   
@@ -41,6 +56,71 @@ QuasarHeader {
     // Multi-ROI Data
     uint8_t roi_count;      // How many targets (0-8)
     ROI targets[8];         // Static array of 8 target slots
+
+    uint8_t wavelet_levels; // Dyadic Haar decomposition depth (0 is read as 1)
+    uint8_t format_version; // Payload format revision (kQuasarFormatVersion)
+    float detail_scale;     // Detail-subband quantization scale (0 = use scale)
+
+    uint32_t sequence;      // Image number, shared by all layers of one image
+    uint8_t layer;          // Progressive layer in this archive (0 = coarsest)
+    uint8_t layer_count;    // Layers the image was split into (1 = whole image)
+    uint16_t max_value;     // Largest sample value of the source image (0 = 255)
+};
+
+// Flight recording (.qsrm): any number of archives in one append-only file.
+//
+//   RecordingFileHeader
+//   per archive: RecordPrefix, then the archive exactly as a .qsr file holds it
+//   index: one RecordingEntry per archive, in recording order
+//   RecordingFooter (the last bytes of the file)
+//
+// The index and footer are written when the recording is closed. A recording
+// cut short (power loss) has neither, but its prefixes still chain through
+// every complete record, so the index can be rebuilt by a scan.
+constexpr uint8_t kRecordingVersion = 1;
+
+struct
+#ifndef _MSC_VER
+__attribute__((packed))
+#endif
+RecordingFileHeader {
+    char magic[4];          // 'Q', 'S', 'R', 'M'
+    uint8_t version;        // kRecordingVersion
+    uint8_t reserved[3];
+};
+
+struct
+#ifndef _MSC_VER
+__attribute__((packed))
+#endif
+RecordPrefix {
+    uint32_t size;          // Archive bytes that follow
+    uint64_t timestamp_us;  // Recording time, microseconds since the Unix epoch
+};
+
+struct
+#ifndef _MSC_VER
+__attribute__((packed))
+#endif
+RecordingEntry {
+    uint64_t timestamp_us;  // Never decreases along the index
+    uint64_t offset;        // File offset of the archive (past its prefix)
+    uint32_t size;          // Archive bytes
+    uint32_t sequence;      // From the archive header: image number...
+    uint32_t target_id;     // ...target feature ID...
+    float est_x, est_y, est_z; // ...and drone pose
+    uint8_t layer;
+    uint8_t layer_count;
+};
+
+struct
+#ifndef _MSC_VER
+__attribute__((packed))
+#endif
+RecordingFooter {
+    uint64_t index_offset;  // File offset of the first RecordingEntry
+    uint32_t count;         // Entries in the index
+    char magic[4];          // 'Q', 'S', 'R', 'I'
 };
 
 #ifdef _MSC_VER
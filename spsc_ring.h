@@ -0,0 +1,78 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <chrono>
+#include <thread>
+
+/**
+ * Bounded single-producer / single-consumer queue.
+ *
+ * push() must only be called from one thread and pop() from one other;
+ * neither locks. Each side publishes its index with a release store and
+ * keeps a cached copy of the other side's index, so the shared cache lines
+ * are only touched when the cached view says the ring is full (or empty).
+ * The indices sit on separate cache lines to avoid false sharing.
+ */
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return slots.size(); }
+
+    // Producer side. Returns false when the ring is full.
+    bool push(const T& value) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == slots.size()) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == slots.size()) return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(T& value) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(kCacheLine) std::atomic<size_t> head{0};  // Next slot to pop (written by the consumer)
+    alignas(kCacheLine) size_t cachedTail = 0;        // Consumer's view of tail
+    alignas(kCacheLine) std::atomic<size_t> tail{0};  // Next slot to push (written by the producer)
+    alignas(kCacheLine) size_t cachedHead = 0;        // Producer's view of head
+};
+
+// Waiting on a ring: spin briefly, then yield, then sleep for `nap`, so a
+// stage waiting on a slower one (or an idle link) does not burn a core
+inline void ringBackoff(int spins, std::chrono::microseconds nap = std::chrono::microseconds(20)) {
+    if (spins < 64) return;
+    if (spins < 256) std::this_thread::yield();
+    else std::this_thread::sleep_for(nap);
+}
+
+#endif // SPSC_RING_H
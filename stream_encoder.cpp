@@ -0,0 +1,240 @@
+#include "stream_encoder.h"
+#include "spsc_ring.h"
+#include "frame_context.h"
+#include "aead.h"
+#include <algorithm>
+#include <thread>
+#include <memory>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <bit>
+#include <span>
+
+using Clock = std::chrono::steady_clock;
+
+// --- Latency histogram ---
+
+void LatencyHistogram::record(std::chrono::nanoseconds d) {
+    const double us = std::max<int64_t>(0, d.count()) / 1000.0;
+    const uint64_t v = static_cast<uint64_t>(us);
+    int index;
+    if (v < kSubBuckets) {
+        index = static_cast<int>(v);
+    } else {
+        // Top bit selects the octave, the next three bits the sub-bucket
+        int msb = std::bit_width(v) - 1;
+        index = (msb - 2) * kSubBuckets + static_cast<int>((v >> (msb - 3)) & (kSubBuckets - 1));
+    }
+    buckets[std::min(index, kBuckets - 1)]++;
+    samples++;
+    totalMicros += us;
+    maxSeen = std::max(maxSeen, us);
+}
+
+double LatencyHistogram::percentileMicros(double p) const {
+    if (samples == 0) return 0.0;
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * samples)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen < target) continue;
+        if (i < kSubBuckets) return i + 1;
+        int msb = i / kSubBuckets + 2;
+        uint64_t lower = static_cast<uint64_t>(kSubBuckets + i % kSubBuckets) << (msb - 3);
+        return std::min(maxSeen, static_cast<double>(lower + (1ull << (msb - 3))));
+    }
+    return maxSeen;
+}
+
+const char* StreamStats::stageName(int stage) {
+    static const char* names[kStages] = {"capture", "transform", "quantize", "entropy", "encrypt", "send"};
+    return stage >= 0 && stage < kStages ? names[stage] : "?";
+}
+
+// --- Stages ---
+
+struct StreamEncoder::FrameSlot : FrameContext {
+    uint64_t index = 0;
+    int levels = 1;
+    bool last = false;          // End-of-stream marker, carries no frame
+    Clock::time_point start;
+};
+
+StreamEncoder::StreamEncoder(const StreamConfig& config) : config(config) {
+    std::random_device rd;
+    for (auto& b : noncePrefix) b = rd() & 0xFF;
+}
+
+void StreamEncoder::transform(FrameSlot& f) const {
+    f.levels = std::clamp(config.levels, 1, std::max(1, maxWaveletLevels(f.img.width, f.img.height)));
+    f.targets = config.targets;
+    if (f.targets.empty()) f.targets.push_back({(uint16_t)(f.img.width / 2), (uint16_t)(f.img.height / 2), 150});
+    transform2D(f.img, f.levels, f.wavelet);
+    applySubbandSaliency(f.img, f.targets, f.levels, config.falloff, 0, 0, f.wavelet);
+}
+
+void StreamEncoder::quantize(FrameSlot& f) const {
+    f.coeffs.resize(f.img.data.size());
+    quantizeCoefficients(f.img, f.coeffs, config.scale, config.detailScale, f.levels, f.wavelet);
+}
+
+void StreamEncoder::entropy(FrameSlot& f) const {
+    f.codec.encode(f.coeffs, f.img.width, f.img.height, f.levels, f.payload);
+}
+
+void StreamEncoder::encrypt(FrameSlot& f) const {
+    QuasarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "QSR1", 4);
+    header.original_size = static_cast<uint64_t>(f.img.width) * f.img.height;
+    header.compression_flags = 0x02 | 0x04 | (config.encrypt ? 0x80 : 0);
+    header.scale = config.scale;
+    header.width = static_cast<uint16_t>(f.img.width);
+    header.height = static_cast<uint16_t>(f.img.height);
+    header.est_x = config.estX; header.est_y = config.estY; header.est_z = config.estZ;
+    header.target_id = config.targetId;
+    header.roi_count = static_cast<uint8_t>(std::min<size_t>(f.targets.size(), 8));
+    for (int k = 0; k < header.roi_count; ++k) header.targets[k] = f.targets[k];
+    header.wavelet_levels = static_cast<uint8_t>(f.levels);
+    header.format_version = kQuasarFormatVersion;
+    header.detail_scale = config.detailScale;
+    header.sequence = static_cast<uint32_t>(f.index);
+    header.layer_count = 1;
+    header.max_value = static_cast<uint16_t>(f.img.maxVal);
+    if (config.encrypt) {
+        // Unique per frame under one key: 64-bit random stream prefix +
+        // 32-bit frame counter. The key outlives a stream, so the prefix has
+        // to keep runs apart (a 32-bit one repeats after ~2^16 runs).
+        std::memcpy(header.nonce, noncePrefix, sizeof(noncePrefix));
+        for (int i = 0; i < 4; ++i) header.nonce[8 + i] = static_cast<uint8_t>(f.index >> (8 * i));
+    }
+
+    const size_t tagSize = config.encrypt ? ChaCha20Poly1305::kTagSize : 0;
+    f.archive.resize(sizeof(header) + f.payload.size() + tagSize);
+    std::memcpy(f.archive.data(), &header, sizeof(header));
+    std::memcpy(f.archive.data() + sizeof(header), f.payload.data(), f.payload.size());
+    if (config.encrypt) {
+        std::span<uint8_t> archive(f.archive);
+        ChaCha20Poly1305::seal(archive.subspan(sizeof(header), f.payload.size()), archive.first(sizeof(header)),
+                               config.key, header.nonce, f.archive.data() + sizeof(header) + f.payload.size());
+    }
+}
+
+void StreamEncoder::process(int stage, FrameSlot& f) const {
+    switch (stage) {
+        case StreamStats::Transform: transform(f); break;
+        case StreamStats::Quantize: quantize(f); break;
+        case StreamStats::Entropy: entropy(f); break;
+        case StreamStats::Encrypt: encrypt(f); break;
+        default: break;
+    }
+}
+
+// --- Runners ---
+
+template <typename T>
+static T popWait(SpscRing<T>& ring) {
+    T value;
+    for (int spins = 0; !ring.pop(value); ++spins) ringBackoff(spins);
+    return value;
+}
+
+template <typename T>
+static void pushWait(SpscRing<T>& ring, const T& value) {
+    for (int spins = 0; !ring.push(value); ++spins) ringBackoff(spins);
+}
+
+StreamStats StreamEncoder::run(const FrameSource& source, const FrameSink& sink) {
+    StreamStats stats;
+    const size_t depth = std::max<size_t>(1, config.ringCapacity);
+
+    // Enough buffers for every ring to fill while each stage holds one
+    std::vector<FrameSlot> pool(depth + StreamStats::kStages);
+    for (FrameSlot& slot : pool) slot.reserve(config.width, config.height, config.levels);
+    SpscRing<FrameSlot*> freeSlots(pool.size());
+    std::vector<std::unique_ptr<SpscRing<FrameSlot*>>> rings;  // rings[s] feeds stage s + 1
+    for (int s = 0; s + 1 < StreamStats::kStages; ++s) rings.push_back(std::make_unique<SpscRing<FrameSlot*>>(depth));
+    for (FrameSlot& slot : pool) freeSlots.push(&slot);
+
+    const auto t0 = Clock::now();
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&] {
+        uint64_t index = 0;
+        while (true) {
+            FrameSlot* f = popWait(freeSlots);
+            auto start = Clock::now();
+            f->last = !source(f->img);
+            const bool last = f->last;
+            if (!last) {
+                f->index = index++;
+                f->start = start;
+                stats.stage[StreamStats::Capture].record(Clock::now() - start);
+            }
+            pushWait(*rings[0], f);
+            if (last) return;
+        }
+    });
+
+    for (int s = StreamStats::Transform; s <= StreamStats::Encrypt; ++s) {
+        threads.emplace_back([&, s] {
+            while (true) {
+                FrameSlot* f = popWait(*rings[s - 1]);
+                const bool last = f->last;
+                if (!last) {
+                    auto start = Clock::now();
+                    process(s, *f);
+                    stats.stage[s].record(Clock::now() - start);
+                }
+                pushWait(*rings[s], f);
+                if (last) return;
+            }
+        });
+    }
+
+    threads.emplace_back([&] {
+        while (true) {
+            FrameSlot* f = popWait(*rings[StreamStats::Send - 1]);
+            if (f->last) return;
+            auto start = Clock::now();
+            sink(f->archive);
+            auto done = Clock::now();
+            stats.stage[StreamStats::Send].record(done - start);
+            stats.endToEnd.record(done - f->start);
+            stats.frames++;
+            pushWait(freeSlots, f);
+        }
+    });
+
+    for (std::thread& t : threads) t.join();
+    stats.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return stats;
+}
+
+StreamStats StreamEncoder::runSerial(const FrameSource& source, const FrameSink& sink) {
+    StreamStats stats;
+    FrameSlot f;
+    f.reserve(config.width, config.height, config.levels);
+    const auto t0 = Clock::now();
+    for (uint64_t index = 0;; ++index) {
+        f.start = Clock::now();
+        if (!source(f.img)) break;
+        f.index = index;
+        auto t = Clock::now();
+        stats.stage[StreamStats::Capture].record(t - f.start);
+        for (int s = StreamStats::Transform; s <= StreamStats::Encrypt; ++s) {
+            process(s, f);
+            auto next = Clock::now();
+            stats.stage[s].record(next - t);
+            t = next;
+        }
+        sink(f.archive);
+        auto done = Clock::now();
+        stats.stage[StreamStats::Send].record(done - t);
+        stats.endToEnd.record(done - f.start);
+        stats.frames++;
+    }
+    stats.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return stats;
+}
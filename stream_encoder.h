@@ -0,0 +1,104 @@
+#ifndef STREAM_ENCODER_H
+#define STREAM_ENCODER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <functional>
+#include "quasar_format.h"
+#include "wavelet.h"
+
+// Log-linear latency histogram: 8 buckets per power of two of microseconds
+// (at most 12.5% relative error), constant memory, O(1) record().
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds d);
+
+    uint64_t count() const { return samples; }
+    double meanMicros() const { return samples ? totalMicros / samples : 0.0; }
+    double maxMicros() const { return maxSeen; }
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 100)
+    double percentileMicros(double p) const;
+
+private:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBuckets = 40 * kSubBuckets;  // Up to ~2^40 us
+    uint64_t buckets[kBuckets] = {};
+    uint64_t samples = 0;
+    double totalMicros = 0.0, maxSeen = 0.0;
+};
+
+// Settings shared by every frame of a stream
+struct StreamConfig {
+    float scale = 10.0f;
+    float detailScale = 0.0f;
+    float falloff = 0.0f;
+    int levels = 3;
+    std::vector<ROI> targets;   // Empty: a radius-150 ROI at each frame's centre
+    float estX = 0.0f, estY = 0.0f, estZ = 0.0f;
+    uint32_t targetId = 0;
+    bool encrypt = false;
+    uint8_t key[32] = {};
+    size_t ringCapacity = 4;    // Frames queued between two stages
+    int width = 0, height = 0;  // Expected frame size: buffers are sized up front (0: on the first frames)
+};
+
+// Capture callback: fills `img` (reusing its storage) with the next frame and
+// returns false at the end of the stream
+using FrameSource = std::function<bool(GrayImage& img)>;
+
+// Send callback: receives each finished archive (header, payload, tag)
+using FrameSink = std::function<void(const std::vector<uint8_t>& archive)>;
+
+struct StreamStats {
+    enum Stage { Capture, Transform, Quantize, Entropy, Encrypt, Send, kStages };
+    static const char* stageName(int stage);
+
+    uint64_t frames = 0;
+    double seconds = 0.0;
+    LatencyHistogram stage[kStages];  // Time spent working, per stage
+    LatencyHistogram endToEnd;        // Capture start to send done
+
+    double fps() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+};
+
+/**
+ * Streaming image encoder.
+ *
+ * run() gives every stage (capture -> transform + saliency -> quantize ->
+ * entropy -> encrypt -> send) its own thread. Stages hand frames on through
+ * lock-free SPSC rings, and frame buffers (one FrameContext per frame in
+ * flight) cycle from send back to capture, so steady state reuses the same
+ * few buffers and allocates nothing. While one frame is being
+ * sent the next is being encrypted, and so on, so throughput is bounded by
+ * the slowest stage instead of the sum of all of them.
+ *
+ * Archives are the same as single-image mode, one per frame, with
+ * header.sequence counting frames. Encrypted frames use a per-stream 8-byte
+ * random nonce prefix followed by a 32-bit frame counter.
+ */
+class StreamEncoder {
+public:
+    explicit StreamEncoder(const StreamConfig& config);
+
+    // Pipelined: one thread per stage; returns when the source is exhausted
+    StreamStats run(const FrameSource& source, const FrameSink& sink);
+
+    // The same stages one after another on the calling thread (baseline)
+    StreamStats runSerial(const FrameSource& source, const FrameSink& sink);
+
+private:
+    struct FrameSlot;
+
+    void transform(FrameSlot& f) const;
+    void quantize(FrameSlot& f) const;
+    void entropy(FrameSlot& f) const;
+    void encrypt(FrameSlot& f) const;
+    void process(int stage, FrameSlot& f) const;  // Transform..Encrypt
+
+    StreamConfig config;
+    uint8_t noncePrefix[8];
+};
+
+#endif // STREAM_ENCODER_H
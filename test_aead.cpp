@@ -0,0 +1,93 @@
+#include "aead.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cassert>
+
+std::vector<uint8_t> from_hex(const std::string& hex) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+int main() {
+    // 1. RFC 8439 2.5.2: Poly1305 on its own, fed in uneven pieces
+    std::vector<uint8_t> polyKey = from_hex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b");
+    std::string msg = "Cryptographic Forum Research Group";
+    Poly1305 poly(polyKey.data());
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(msg.data());
+    poly.update(m, 5);
+    poly.update(m + 5, 20);
+    poly.update(m + 25, msg.size() - 25);
+    uint8_t polyTag[16];
+    poly.finish(polyTag);
+    assert(std::vector<uint8_t>(polyTag, polyTag + 16) == from_hex("a8061dc1305136c6c22b8baf0c0127a9"));
+    std::cout << "Poly1305 test vector passed" << std::endl;
+
+    // 2. RFC 8439 2.8.2: AEAD seal
+    std::vector<uint8_t> key = from_hex("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f");
+    std::vector<uint8_t> nonce = from_hex("070000004041424344454647");
+    std::vector<uint8_t> aad = from_hex("50515253c0c1c2c3c4c5c6c7");
+    std::string plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                            "for the future, sunscreen would be it.";
+    std::vector<uint8_t> data(plaintext.begin(), plaintext.end());
+    uint8_t tag[ChaCha20Poly1305::kTagSize];
+    ChaCha20Poly1305::seal(data, aad, key.data(), nonce.data(), tag);
+    assert(data == from_hex("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+                            "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+                            "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+                            "3ff4def08e4b7a9de576d26586cec64b6116"));
+    assert(std::vector<uint8_t>(tag, tag + 16) == from_hex("1ae10b594f09e26a7e902ecbd0600691"));
+    std::cout << "ChaCha20-Poly1305 test vector passed" << std::endl;
+
+    // 3. Streaming decrypt in odd-sized chunks matches the one-shot path
+    std::vector<uint8_t> sealed = data;
+    ChaCha20Poly1305 rx(key.data(), nonce.data());
+    rx.aad(aad.data(), 7);
+    rx.aad(aad.data() + 7, aad.size() - 7);
+    size_t pos = 0;
+    for (size_t chunk : {1, 63, 2, 30}) {
+        rx.decrypt(sealed.data() + pos, chunk);
+        pos += chunk;
+    }
+    rx.decrypt(sealed.data() + pos, sealed.size() - pos);
+    bool authentic = rx.verify(tag);
+    assert(authentic && std::string(sealed.begin(), sealed.end()) == plaintext);
+
+    // 4. Any flipped bit in ciphertext, AAD or tag is rejected and wiped
+    std::vector<uint8_t> tampered = data;
+    tampered[40] ^= 0x01;
+    authentic = ChaCha20Poly1305::open(tampered, aad, key.data(), nonce.data(), tag);
+    assert(!authentic && tampered == std::vector<uint8_t>(tampered.size(), 0));
+    std::vector<uint8_t> badAad = aad;
+    badAad[0] ^= 0x80;
+    std::vector<uint8_t> copy = data;
+    authentic = ChaCha20Poly1305::open(copy, badAad, key.data(), nonce.data(), tag);
+    assert(!authentic);
+    uint8_t badTag[16];
+    std::copy(tag, tag + 16, badTag);
+    badTag[15] ^= 0x10;
+    copy = data;
+    authentic = ChaCha20Poly1305::open(copy, aad, key.data(), nonce.data(), badTag);
+    assert(!authentic);
+    copy = data;
+    authentic = ChaCha20Poly1305::open(copy, aad, key.data(), nonce.data(), tag);
+    assert(authentic);
+
+    // check() authenticates without decrypting; decryptChecked() then
+    // deciphers without a second MAC pass
+    std::vector<uint8_t> flipped = data;
+    flipped[40] ^= 0x01;
+    bool good = ChaCha20Poly1305::check(data, aad, key.data(), nonce.data(), tag);
+    bool forged = ChaCha20Poly1305::check(flipped, aad, key.data(), nonce.data(), tag);
+    assert(good && !forged);
+    std::vector<uint8_t> checked = data;
+    ChaCha20Poly1305::decryptChecked(checked, key.data(), nonce.data());
+    assert(std::string(checked.begin(), checked.end()) == plaintext);
+    assert(std::string(copy.begin(), copy.end()) == plaintext);
+
+    std::cout << "AEAD Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include "archive_io.h"
+#include "aead.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <limits>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+std::vector<uint8_t> readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "quasar_test_archive_io";
+    fs::create_directories(dir);
+    const std::string path = (dir / "frame.qsr").string();
+
+    QuasarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "QSR1", 4);
+    header.format_version = kQuasarFormatVersion;
+    header.width = 640;
+    header.height = 480;
+    header.target_id = 7;
+    std::vector<uint8_t> payload(300000);
+    for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i * 131 + (i >> 9));
+
+    // 1. Gathered write, then the mapped view sees exactly header + payload
+    bool written = writeArchive(path, header, payload);
+    assert(written);
+    std::vector<uint8_t> file = readFile(path);
+    assert(file.size() == sizeof(header) + payload.size());
+    assert(std::memcmp(file.data(), &header, sizeof(header)) == 0);
+    assert(std::equal(payload.begin(), payload.end(), file.begin() + sizeof(header)));
+    {
+        MappedArchive archive;
+        bool opened = archive.open(path);
+        assert(opened);
+        assert(archive.size() == file.size());
+        assert(archive.header().width == 640 && archive.header().target_id == 7);
+        assert(std::memcmp(archive.headerBytes().data(), &header, sizeof(header)) == 0);
+        std::span<uint8_t> view = archive.payload();
+        assert(std::equal(view.begin(), view.end(), payload.begin(), payload.end()));
+    }
+
+    // 2. Encrypted: tag written from its own buffer, payload decrypted in
+    // place in the mapping without changing the file
+    uint8_t key[32], tag[ChaCha20Poly1305::kTagSize];
+    for (int i = 0; i < 32; ++i) key[i] = static_cast<uint8_t>(i * 3);
+    header.compression_flags = 0x80;
+    for (int i = 0; i < 12; ++i) header.nonce[i] = static_cast<uint8_t>(i + 1);
+    std::vector<uint8_t> sealed = payload;
+    const std::span<const uint8_t> aad(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    ChaCha20Poly1305::seal(sealed, aad, key, header.nonce, tag);
+    written = writeArchive(path, header, sealed, tag);
+    assert(written);
+    const std::vector<uint8_t> onDisk = readFile(path);
+    assert(onDisk.size() == sizeof(header) + payload.size() + sizeof(tag));
+    {
+        MappedArchive archive;
+        bool opened = archive.open(path);
+        assert(opened);
+        std::span<uint8_t> p = archive.payload();
+        const size_t dataSize = p.size() - ChaCha20Poly1305::kTagSize;
+        bool authentic = ChaCha20Poly1305::open(p.first(dataSize), archive.headerBytes(), key, archive.header().nonce,
+                                                p.data() + dataSize);
+        assert(authentic);
+        assert(std::equal(payload.begin(), payload.end(), p.begin()));
+    }
+    assert(readFile(path) == onDisk);  // Copy-on-write: the archive is untouched
+
+    // 3. Rejected: missing, truncated and foreign files
+    MappedArchive archive;
+    bool opened = archive.open((dir / "missing.qsr").string());
+    assert(!opened);
+    std::ofstream(dir / "short.qsr", std::ios::binary).write(reinterpret_cast<const char*>(onDisk.data()), 20);
+    opened = archive.open((dir / "short.qsr").string());
+    assert(!opened);
+    std::vector<uint8_t> foreign = onDisk;
+    std::memcpy(foreign.data(), "PK\x03\x04", 4);
+    std::ofstream(dir / "foreign.qsr", std::ios::binary).write(reinterpret_cast<const char*>(foreign.data()), foreign.size());
+    opened = archive.open((dir / "foreign.qsr").string());
+    assert(!opened);
+
+    // An archive with no payload at all maps to an empty payload span
+    written = writeArchive(path, header, {});
+    opened = archive.open(path);
+    assert(written && opened && archive.payload().empty());
+    archive.close();
+
+    // 4. Flight recording: 60 archives, every third image sent as 3 layers
+    const std::string recPath = (dir / "flight.qsrm").string();
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    std::vector<QuasarHeader> headers;
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<uint64_t> times;
+    RecordingWriter writer;
+    opened = writer.open(recPath);
+    assert(opened);
+    for (uint32_t n = 0; headers.size() < 60; ++n) {
+        const int layers = n % 3 == 0 ? 3 : 1;
+        for (int l = 0; l < layers && headers.size() < 60; ++l) {
+            QuasarHeader h = header;
+            h.compression_flags = 0x02 | 0x04;
+            h.sequence = 1000 + n;
+            h.layer = static_cast<uint8_t>(l);
+            h.layer_count = static_cast<uint8_t>(layers);
+            h.est_x = coord(rng); h.est_y = coord(rng); h.est_z = coord(rng) + 60.0f;
+            std::vector<uint8_t> p(100 + rng() % 5000);
+            for (auto& b : p) b = static_cast<uint8_t>(rng());
+            const uint64_t t = 1'700'000'000'000'000ull + headers.size() * 33'000;
+            bool appended;
+            if (headers.size() % 2) {
+                appended = writer.append(h, p, {}, t);
+            } else {
+                std::vector<uint8_t> whole(sizeof(h) + p.size());
+                std::memcpy(whole.data(), &h, sizeof(h));
+                std::memcpy(whole.data() + sizeof(h), p.data(), p.size());
+                appended = writer.append(whole, t);
+            }
+            assert(appended);
+            headers.push_back(h);
+            payloads.push_back(std::move(p));
+            times.push_back(t);
+        }
+    }
+    // A clock step backwards is clamped: the index stays sorted by time
+    QuasarHeader late = header;
+    late.sequence = 5000;
+    bool appended = writer.append(late, payload, {}, times.back() - 1'000'000);
+    assert(appended && writer.frames() == 61);
+    bool closed = writer.close();
+    assert(closed);
+
+    auto checkRecording = [&](RecordingReader& rec, size_t expected) {
+        assert(rec.size() == expected);
+        for (size_t i = 0; i < std::min<size_t>(expected, headers.size()); ++i) {
+            ArchiveView view;
+            const bool found = rec.archive(i, view);
+            assert(found && std::memcmp(&view.header, &headers[i], sizeof(QuasarHeader)) == 0);
+            std::span<uint8_t> p = view.payload();
+            assert(std::equal(p.begin(), p.end(), payloads[i].begin(), payloads[i].end()));
+            assert(rec.index()[i].timestamp_us == times[i] && rec.index()[i].sequence == headers[i].sequence);
+        }
+    };
+    {
+        RecordingReader rec;
+        opened = rec.open(recPath);
+        assert(opened && !rec.recovered());
+        checkRecording(rec, 61);
+        assert(rec.index()[60].timestamp_us == times.back() && rec.index()[60].sequence == 5000);
+
+        // Seek by time
+        assert(rec.seekTime(0) == 0);
+        assert(rec.seekTime(times[17]) == 17 && rec.seekTime(times[17] + 1) == 18);
+        assert(rec.seekTime(times.back() + 1) == rec.size());
+
+        // Every layer of one image, in order
+        std::vector<size_t> layers = rec.findSequence(1003);
+        assert(layers.size() == 3);
+        for (size_t k = 0; k < 3; ++k) assert(rec.index()[layers[k]].layer == k);
+        assert(rec.findSequence(1001).size() == 1 && rec.findSequence(77).empty());
+
+        // Pose box against a brute-force scan
+        const Pose lo = {-20.0f, -30.0f, 40.0f}, hi = {25.0f, 10.0f, 90.0f};
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            const QuasarHeader& h = headers[i];
+            if (h.est_x >= lo.x && h.est_x <= hi.x && h.est_y >= lo.y && h.est_y <= hi.y && h.est_z >= lo.z && h.est_z <= hi.z) {
+                expected.push_back(i);
+            }
+        }
+        assert(!expected.empty() && rec.findPose(lo, hi) == expected);
+    }
+
+    // Poses without a fix (NaN) match no box and do not hide the others
+    {
+        const std::string nanPath = (dir / "nan.qsrm").string();
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        RecordingWriter w;
+        opened = w.open(nanPath);
+        assert(opened);
+        for (int i = 0; i < 10; ++i) {
+            QuasarHeader h = header;
+            h.est_x = i % 3 == 1 ? nan : static_cast<float>(i);
+            h.est_y = i == 6 ? nan : 0.0f;
+            h.est_z = 0.0f;
+            appended = w.append(h, payload, {}, 1000 + i);
+            assert(appended);
+        }
+        closed = w.close();
+        assert(closed);
+        RecordingReader rec;
+        opened = rec.open(nanPath);
+        assert(opened);
+        assert(rec.findPose({0, -1, -1}, {10, 1, 1}) == std::vector<size_t>({0, 2, 3, 5, 8, 9}));
+        assert(rec.findPose({nan, -1, -1}, {10, 1, 1}).empty());
+    }
+
+    // 5. A recorder cut off mid-record: no index, a torn last record. The
+    // index is rebuilt from the complete records, and appending resumes there.
+    const std::vector<uint8_t> full = readFile(recPath);
+    size_t cut = 0;
+    {
+        RecordingReader rec;
+        opened = rec.open(recPath);
+        assert(opened);
+        cut = rec.index()[40].offset + 50;
+    }
+    std::ofstream(recPath, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(full.data()), cut);
+    {
+        RecordingReader rec;
+        opened = rec.open(recPath);
+        assert(opened && rec.recovered());
+        checkRecording(rec, 40);
+    }
+    opened = writer.open(recPath, true);
+    assert(opened && writer.frames() == 40);
+    appended = writer.append(headers[40], payloads[40], {}, times[40]);
+    closed = writer.close();
+    assert(appended && closed);
+    {
+        RecordingReader rec;
+        opened = rec.open(recPath);
+        assert(opened && !rec.recovered());
+        checkRecording(rec, 41);
+    }
+
+    // A forged footer whose index offset wraps around past the file end: the
+    // index is ignored and the (empty) file scanned instead
+    {
+        RecordingFileHeader fh = {{'Q', 'S', 'R', 'M'}, kRecordingVersion, {}};
+        RecordingFooter footer = {0ull - (sizeof(RecordingEntry) + sizeof(RecordingFooter)), 1, {'Q', 'S', 'R', 'I'}};
+        std::ofstream evil(recPath, std::ios::binary | std::ios::trunc);
+        evil.write(reinterpret_cast<const char*>(&fh), sizeof(fh));
+        evil.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    }
+    {
+        RecordingReader rec;
+        opened = rec.open(recPath);
+        assert(opened && rec.recovered() && rec.size() == 0);
+    }
+
+    // Not a recording
+    RecordingReader notRecording;
+    opened = notRecording.open((dir / "foreign.qsr").string());
+    assert(!opened);
+    opened = writer.open((dir / "foreign.qsr").string(), true);
+    assert(!opened);
+
+    fs::remove_all(dir);
+    std::cout << "Archive IO Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
@@ -1,8 +1,11 @@
 #include "chacha.h"
+#include "chacha_kernels.h"
 #include <iostream>
 #include <vector>
 #include <cassert>
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
 
 void print_bytes(const std::string& label, const std::vector<uint8_t>& data) {
     std::cout << label << ": ";
@@ -12,6 +15,14 @@ void print_bytes(const std::string& label, const std::vector<uint8_t>& data) {
     std::cout << std::dec << std::endl;
 }
 
+std::vector<uint8_t> from_hex(const std::string& hex) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
 int main() {
     std::string plaintext = "ChaCha20 is a stream cipher developed by Daniel J. Bernstein.";
     std::vector<uint8_t> data(plaintext.begin(), plaintext.end());
@@ -34,6 +45,82 @@ int main() {
     std::cout << "Decrypted: " << result << std::endl;
 
     assert(plaintext == result);
+
+    // RFC 7539 test vectors
+    uint8_t rfcKey[32];
+    for (int i = 0; i < 32; ++i) rfcKey[i] = static_cast<uint8_t>(i);
+
+    // 2.3.2: block function, counter 1 (keystream = encrypting zeros)
+    const uint8_t blockNonce[12] = {0, 0, 0, 0x09, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    std::vector<uint8_t> keystream(64, 0);
+    ChaCha20::process(keystream, rfcKey, blockNonce, 1);
+    assert(keystream == from_hex("10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+                                 "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e"));
+
+    // 2.4.2: encryption of the "sunscreen" plaintext, counter 1
+    const uint8_t encNonce[12] = {0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    std::string sunscreen = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                            "for the future, sunscreen would be it.";
+    std::vector<uint8_t> rfcData(sunscreen.begin(), sunscreen.end());
+    ChaCha20::process(rfcData, rfcKey, encNonce, 1);
+    assert(rfcData == from_hex("6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+                               "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+                               "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+                               "5af90bbf74a35be6b40b8eedf2785e42874d"));
+
+    // A.1 #1: all-zero key and nonce, counter 0
+    const uint8_t zeroKey[32] = {0};
+    const uint8_t zeroNonce[12] = {0};
+    std::vector<uint8_t> zeros(64, 0);
+    ChaCha20::process(zeros, zeroKey, zeroNonce, 0);
+    assert(zeros == from_hex("76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7"
+                             "da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586"));
+    std::cout << "RFC 7539 test vectors passed" << std::endl;
+
+    // Dispatched multi-block kernels against the scalar reference, across the
+    // 8-way, 4-way and single-block paths and a counter that wraps mid-run
+    const ChaChaKernels& ref = chachaScalarKernels();
+    const ChaChaKernels& simd = chachaKernels();
+    uint32_t state[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    std::memcpy(&state[4], rfcKey, 32);
+    state[12] = 0xFFFFFFFA;
+    std::memcpy(&state[13], encNonce, 12);
+    for (size_t blocks = 0; blocks <= 19; ++blocks) {
+        std::vector<uint8_t> in(blocks * 64), a(blocks * 64), b(blocks * 64);
+        for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<uint8_t>(i * 31 + 7);
+        ref.xorBlocks(state, in.data(), a.data(), blocks);
+        simd.xorBlocks(state, in.data(), b.data(), blocks);
+        assert(a == b);
+    }
+    std::cout << "Kernels (" << simd.name << ") match scalar reference" << std::endl;
+
+    // Streaming context: uneven pieces, and 1400-byte UDP-sized chunks
+    // decrypted out of order with seek(), reproduce the one-shot cipher
+    std::vector<uint8_t> stream(5000);
+    for (size_t i = 0; i < stream.size(); ++i) stream[i] = static_cast<uint8_t>(i * 13 + 1);
+    std::vector<uint8_t> oneShot = stream;
+    ChaCha20::process(oneShot, key, nonce);
+
+    std::vector<uint8_t> pieces = stream;
+    ChaCha20 tx(key, nonce);
+    size_t offset = 0;
+    for (size_t len : {1, 63, 64, 65, 130, 7}) {
+        tx.process(std::span<uint8_t>(pieces.data() + offset, len));
+        offset += len;
+    }
+    tx.process(std::span<uint8_t>(pieces.data() + offset, pieces.size() - offset));
+    assert(pieces == oneShot && tx.position() == stream.size());
+
+    ChaCha20 rx(key, nonce);
+    std::vector<uint8_t> recovered(stream.size());
+    for (size_t chunk : {3, 0, 2, 1}) {
+        size_t begin = chunk * 1400, len = std::min<size_t>(1400, stream.size() - begin);
+        rx.seek(begin);
+        rx.process(std::span<const uint8_t>(oneShot.data() + begin, len), std::span<uint8_t>(recovered.data() + begin, len));
+    }
+    assert(recovered == stream);
+    std::cout << "Streaming context with seek matches one-shot cipher" << std::endl;
+
     std::cout << "Encryption Verification SUCCESSFUL!" << std::endl;
 
     return 0;
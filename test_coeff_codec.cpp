@@ -0,0 +1,147 @@
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <climits>
+#include <random>
+#include "coeff_codec.h"
+#include "huffman.h"
+#include "varint.h"
+#include "wavelet.h"
+#include "progressive.h"
+#include <cmath>
+
+int main() {
+    CoefficientCodec codec;
+    const int W = 75, H = 41, levels = 3;
+
+    // Subbands partition the plane exactly
+    size_t area = 0;
+    for (const Subband& b : subbandLayout(W, H, levels)) area += static_cast<size_t>(b.width) * b.height;
+    assert(area == static_cast<size_t>(W) * H);
+
+    // Mostly-zero plane with a dense "ROI" block and a few extreme values
+    std::mt19937 rng(7);
+    std::vector<int32_t> coeffs(W * H, 0);
+    for (int y = 10; y < 30; ++y) {
+        for (int x = 20; x < 60; ++x) {
+            coeffs[y * W + x] = static_cast<int32_t>(rng() % 2001) - 1000;
+        }
+    }
+    coeffs[0] = 2147483647;
+    coeffs[1] = -2147483647;
+    coeffs[W * H - 1] = -1;
+
+    coeffs[2] = INT32_MIN;  // Clamped to -INT32_MAX
+
+    auto encoded = codec.encode(coeffs, W, H, levels);
+    std::cout << "Coefficients: " << coeffs.size() * 4 << " bytes -> " << encoded.size() << " bytes" << std::endl;
+
+    std::vector<int32_t> decoded;
+    bool ok = codec.decode(encoded, W, H, levels, decoded);
+    assert(ok && decoded[2] == -INT32_MAX);
+    coeffs[2] = -INT32_MAX;
+    assert(decoded == coeffs);
+
+    // Damage that still parses is rejected: bytes after the last band, and a
+    // band whose symbols stop before its last coefficient
+    std::vector<uint8_t> trailing = encoded;
+    trailing.push_back(0);
+    ok = codec.decode(trailing, W, H, levels, decoded);
+    assert(!ok);
+    {
+        // 4x4, one level: four 2x2 bands. LL holds a single 1 and then either
+        // ends (end-of-band symbol) or just stops.
+        auto stream = [](std::vector<uint8_t> symbols) {
+            std::vector<uint8_t> out;
+            std::vector<uint8_t> coded = HuffmanCodec().compress(symbols);
+            writeVarint(coded.size(), out);
+            out.insert(out.end(), coded.begin(), coded.end());
+            writeVarint(1, out);
+            out.push_back(0x00);           // Sign bit 0, no magnitude bits
+            out.insert(out.end(), 3, 0);   // Three all-zero bands
+            return out;
+        };
+        std::vector<int32_t> small;
+        ok = codec.decode(stream({0x01, 0x00}), 4, 4, 1, small);
+        assert(ok && small[0] == 1);
+        ok = codec.decode(stream({0x01}), 4, 4, 1, small);
+        assert(!ok);
+        ok = codec.decode(stream({0x01, 0x00, 0x01}), 4, 4, 1, small);  // Symbols past end of band
+        assert(!ok);
+    }
+
+    // An all-zero plane costs one byte per subband
+    std::vector<int32_t> zeros(W * H, 0);
+    auto zeroEncoded = codec.encode(zeros, W, H, levels);
+    assert(zeroEncoded.size() == subbandLayout(W, H, levels).size());
+    ok = codec.decode(zeroEncoded, W, H, levels, decoded);
+    assert(ok && decoded == zeros);
+
+    // Progressive layers: each band range decodes on its own, and together
+    // they rebuild the plane in any order
+    auto layers = progressiveLayers(levels);
+    assert(layers.size() == static_cast<size_t>(levels));
+    std::vector<int32_t> merged(W * H, 7);
+    for (int i = levels - 1; i >= 0; --i) {
+        auto part = codec.encodeBands(coeffs, W, H, levels, layers[i].firstBand, layers[i].bandCount);
+        ok = codec.decodeBands(part, W, H, levels, layers[i].firstBand, layers[i].bandCount, merged);
+        assert(ok);
+    }
+    assert(merged == coeffs);
+
+    // ProgressiveDecoder: the coarse layer alone gives a low-resolution
+    // preview, the remaining layers refine it to the full reconstruction
+    GrayImage img(64, 48);
+    for (int y = 0; y < img.height; ++y) {
+        for (int x = 0; x < img.width; ++x) img.data[y * img.width + x] = 128.0f + 60.0f * std::sin(x * 0.2f) * std::cos(y * 0.15f);
+    }
+    GrayImage original = img;
+    transform2D(img, levels);
+    auto quantized = quantizeCoefficients(img, 100.0f, 0.0f, levels);
+    QuasarHeader header{};
+    header.compression_flags = 0x06;
+    header.scale = 100.0f;
+    header.width = 64;
+    header.height = 48;
+    header.wavelet_levels = levels;
+    header.sequence = 42;
+    header.layer_count = static_cast<uint8_t>(levels);
+    auto rmse = [&](const GrayImage& a) {
+        double sum = 0;
+        for (size_t i = 0; i < a.data.size(); ++i) sum += (a.data[i] - original.data[i]) * (a.data[i] - original.data[i]);
+        return std::sqrt(sum / a.data.size());
+    };
+    ProgressiveDecoder progressive;
+    GrayImage preview(0, 0);
+    double previous = 1e30;
+    for (int i = 0; i < levels; ++i) {
+        header.layer = static_cast<uint8_t>(i);
+        auto part = codec.encodeBands(quantized, 64, 48, levels, layers[i].firstBand, layers[i].bandCount);
+        ok = progressive.addLayer(header, part);
+        const bool duplicate = progressive.addLayer(header, part);
+        assert(ok && !duplicate);
+        progressive.render(preview);
+        double error = rmse(preview);
+        std::cout << "Progressive layer " << i + 1 << "/" << levels << ": " << part.size() << " bytes, RMSE " << error << std::endl;
+        assert(error < previous);
+        previous = error;
+    }
+    assert(progressive.complete() && previous < 0.01);
+
+    // A new sequence restarts; late layers of the old one are dropped
+    header.sequence = 43;
+    header.layer = 0;
+    ok = progressive.addLayer(header, codec.encodeBands(quantized, 64, 48, levels, 0, 4));
+    assert(ok && progressive.layersReceived() == 1 && !progressive.complete());
+    header.sequence = 42;
+    ok = progressive.addLayer(header, codec.encodeBands(quantized, 64, 48, levels, 0, 4));
+    assert(!ok);
+
+    // Truncation is reported, not silently decoded
+    encoded.resize(encoded.size() / 2);
+    ok = codec.decode(encoded, W, H, levels, decoded);
+    assert(!ok);
+
+    std::cout << "Coefficient Codec Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
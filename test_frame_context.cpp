@@ -0,0 +1,154 @@
+#include "frame_context.h"
+#include "stream_encoder.h"
+#include "coeff_codec.h"
+#include "huffman.h"
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <new>
+#include <cmath>
+#include <cstdlib>
+#include <cassert>
+
+// Every heap allocation in the process, on any thread
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t a = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Synthetic frame `n` of five that take turns: a moving pattern plus texture,
+// so consecutive payloads differ in size
+void makeFrame(GrayImage& img, int n) {
+    const int width = 160, height = 120;
+    img.width = width;
+    img.height = height;
+    img.data.resize(width * height);
+    const int phase = n % 5;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            img.data[y * width + x] = 128.0f + 90.0f * std::sin((x + 3 * phase) * 0.21f) * std::cos(y * 0.17f) +
+                                      ((x * 7 + y * 13 + phase * 29) % (7 + 4 * phase));
+        }
+    }
+}
+
+int main() {
+    // 1. Reused codecs and output buffers produce the same bytes as fresh ones
+    {
+        CoefficientCodec reused;
+        HuffmanCodec huffman;
+        std::vector<uint8_t> payload, compressed;
+        for (int n = 0; n < 10; ++n) {
+            GrayImage img(0, 0);
+            makeFrame(img, n);
+            transform2D(img, 3);
+            applySubbandSaliency(img, {{80, 60, static_cast<uint16_t>(30 + 4 * n)}}, 3, 8.0f);
+            std::vector<int32_t> coeffs = quantizeCoefficients(img, 10.0f, 4.0f, 3);
+
+            reused.encode(coeffs, img.width, img.height, 3, payload);
+            assert(payload == CoefficientCodec().encode(coeffs, img.width, img.height, 3));
+            reused.encodeBands(coeffs, img.width, img.height, 3, 1 + n % 4, 3, payload);
+            assert(payload == CoefficientCodec().encodeBands(coeffs, img.width, img.height, 3, 1 + n % 4, 3));
+
+            const std::vector<uint8_t> bytes(payload.begin(), payload.begin() + payload.size() / (n + 1));
+            huffman.compress(bytes, compressed);
+            assert(compressed == HuffmanCodec().compress(bytes));
+        }
+        huffman.compress(std::vector<uint8_t>(), compressed);
+        assert(compressed.empty());
+        std::cout << "Reused codec buffers match fresh encodes" << std::endl;
+    }
+
+    // 2. A reused FrameContext stops allocating: after the first pass over
+    // the five frames, the stages encode every frame in place
+    {
+        FrameContext ctx;
+        ctx.reserve(160, 120, 3);
+        const std::vector<ROI> targets = {{80, 60, 40}, {20, 20, 15}};
+        uint64_t before = 0;
+        for (int n = 0; n < 25; ++n) {
+            if (n == 5) before = allocations.load();
+            makeFrame(ctx.img, n);
+            ctx.targets = targets;
+            transform2D(ctx.img, 3, ctx.wavelet);
+            applySubbandSaliency(ctx.img, ctx.targets, 3, 6.0f, 0, 0, ctx.wavelet);
+            ctx.coeffs.resize(ctx.img.data.size());
+            quantizeCoefficients(ctx.img, ctx.coeffs, 10.0f, 4.0f, 3, ctx.wavelet);
+            ctx.codec.encode(ctx.coeffs, ctx.img.width, ctx.img.height, 3, ctx.payload);
+            ctx.archive.assign(ctx.payload.begin(), ctx.payload.end());
+        }
+        assert(allocations.load() == before);
+        std::cout << "FrameContext: 20 frames, 0 allocations" << std::endl;
+    }
+
+    // 3. Steady-state streaming, serial and pipelined, encrypted, with and
+    // without pre-sized buffers: no allocation anywhere in the process
+    // between frame `warm` and the end of the stream
+    for (bool pipelined : {false, true}) {
+        for (bool presized : {true, false}) {
+            StreamConfig config;
+            config.levels = 3;
+            config.targets = {{80, 60, 40}};
+            config.falloff = 6.0f;
+            config.encrypt = true;
+            config.ringCapacity = 2;
+            if (presized) {
+                config.width = 160;
+                config.height = 120;
+            }
+            // By frame 10 every thread is running (the capture stage cannot run
+            // more than the 8 slots ahead of send). Without pre-sizing every
+            // slot also has to see each of the five frames once.
+            const int warm = presized ? 10 : 100, frames = warm + 200;
+            int n = 0;
+            uint64_t atWarm = 0, atEnd = 0;
+            size_t bytes = 0;
+            FrameSource source = [&](GrayImage& img) {
+                if (n == warm) atWarm = allocations.load();
+                if (n == frames) {
+                    atEnd = allocations.load();
+                    return false;
+                }
+                makeFrame(img, n++);
+                return true;
+            };
+            FrameSink sink = [&](const std::vector<uint8_t>& archive) { bytes += archive.size(); };
+            StreamEncoder encoder(config);
+            StreamStats stats = pipelined ? encoder.run(source, sink) : encoder.runSerial(source, sink);
+            assert(stats.frames == static_cast<uint64_t>(frames) && bytes > 0);
+            assert(atEnd == atWarm);
+            std::cout << (pipelined ? "Pipelined" : "Serial") << (presized ? ", pre-sized" : ", grown")
+                      << ": " << frames - warm << " frames, " << atEnd - atWarm << " allocations" << std::endl;
+        }
+    }
+
+    std::cout << "Frame Context Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include "frame_ingest.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cassert>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace fs = std::filesystem;
+
+// Deterministic samples for frame `seq`
+uint16_t sample(uint32_t seq, size_t i, int maxValue) {
+    return static_cast<uint16_t>((seq * 7919 + i * 31) % (maxValue + 1));
+}
+
+void fill(uint8_t* dst, uint32_t seq, size_t n, int maxValue) {
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t v = sample(seq, i, maxValue);
+        if (maxValue > 255) {
+            dst[2 * i] = static_cast<uint8_t>(v);
+            dst[2 * i + 1] = static_cast<uint8_t>(v >> 8);
+        } else {
+            dst[i] = static_cast<uint8_t>(v);
+        }
+    }
+}
+
+bool matches(const GrayImage& img, uint32_t seq, int width, int height, int maxValue) {
+    if (img.width != width || img.height != height || img.maxVal != maxValue) return false;
+    for (size_t i = 0; i < img.data.size(); ++i) {
+        if (img.data[i] != sample(seq, i, maxValue)) return false;
+    }
+    return true;
+}
+
+struct Shape { uint16_t width, height, maxValue; };
+const Shape kShapes[] = {{64, 48, 255}, {33, 17, 4095}, {64, 48, 65535}, {7, 3, 255}};
+
+int main() {
+    const std::string name = "/quasar_test_ring_" + std::to_string(getpid());
+
+    // 1. Producer and consumer threads through a 4-slot ring. Every fifth
+    // frame is offered without waiting and may be dropped when the ring is full.
+    {
+        FrameRingWriter writer;
+        bool created = writer.create(name, 4, 64 * 48 * 2);
+        FrameRingReader reader;
+        bool opened = reader.open(name);
+        assert(created && opened);
+        uint8_t* oversized = writer.claim(65, 48, 65535);
+        assert(oversized == nullptr);  // Larger than a slot: dropped too
+
+        const int frames = 300;
+        std::vector<uint32_t> published;
+        std::thread producer([&] {
+            for (uint32_t seq = 1; seq <= frames; ++seq) {
+                const Shape& s = kShapes[seq % 4];
+                uint8_t* dst = writer.claim(s.width, s.height, s.maxValue, seq % 5 != 0);
+                if (!dst) continue;
+                fill(dst, seq, static_cast<size_t>(s.width) * s.height, s.maxValue);
+                writer.publish();
+                published.push_back(seq);
+            }
+            writer.close();
+        });
+        std::vector<GrayImage> received;
+        GrayImage img(0, 0);
+        while (reader.next(img)) received.push_back(img);
+        producer.join();
+
+        assert(received.size() == published.size());
+        for (size_t i = 0; i < received.size(); ++i) {
+            const Shape& s = kShapes[published[i] % 4];
+            assert(matches(received[i], published[i], s.width, s.height, s.maxValue));
+        }
+        // Gaps between delivered frames: the oversized frame came before the
+        // first one, and drops after the last one leave no gap
+        assert(reader.dropped() == published.back() - published.front() + 1 - published.size());
+        std::cout << "Ring: " << received.size() << " frames, " << reader.dropped() << " dropped by the producer" << std::endl;
+    }
+
+    // The writer unlinked the ring on close
+    FrameRingReader reader;
+    bool opened = reader.open(name);
+    assert(!opened);
+
+    // 2. stop() ends a wait on an idle ring
+    {
+        FrameRingWriter writer;
+        bool created = writer.create(name, 2, 16);
+        opened = reader.open(name);
+        assert(created && opened);
+        std::thread stopper([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            reader.stop();
+        });
+        GrayImage img(0, 0);
+        bool got = reader.next(img);
+        stopper.join();
+        assert(!got);
+        reader.close();
+    }
+
+    // 3. A producer that dies without closing: its frames are still read,
+    // then the stream ends instead of waiting forever
+    pid_t child = fork();
+    if (child == 0) {
+        FrameRingWriter writer;
+        if (!writer.create(name, 2, 64)) _exit(1);
+        uint8_t* dst = writer.claim(8, 8);
+        fill(dst, 0, 64, 255);
+        writer.publish();
+        _exit(0);  // No close(): the ring is neither closed nor unlinked
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    {
+        opened = reader.open(name);
+        assert(opened);
+        GrayImage img(0, 0);
+        bool got = reader.next(img);
+        assert(got && matches(img, 0, 8, 8, 255));
+        got = reader.next(img);
+        assert(!got);
+        reader.close();
+        shm_unlink(name.c_str());
+    }
+
+    // 4. Raw frames back to back in a pipe (here a file)
+    const fs::path path = fs::temp_directory_path() / "quasar_test_raw_frames";
+    std::vector<uint8_t> stream;
+    auto append = [&](uint32_t seq, const Shape& s) {
+        FrameDescriptor d = {};
+        std::memcpy(d.magic, "QSRF", 4);
+        d.sequence = seq;
+        d.width = s.width;
+        d.height = s.height;
+        d.max_value = s.maxValue;
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&d);
+        stream.insert(stream.end(), p, p + sizeof(d));
+        const size_t n = static_cast<size_t>(s.width) * s.height;
+        std::vector<uint8_t> samples(n * (s.maxValue > 255 ? 2 : 1));
+        fill(samples.data(), seq, n, s.maxValue);
+        stream.insert(stream.end(), samples.begin(), samples.end());
+    };
+    append(10, kShapes[0]);
+    append(11, kShapes[1]);
+    append(14, kShapes[2]);  // Frames 12 and 13 were dropped
+    auto writeStream = [&](size_t bytes) {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(stream.data()), bytes);
+    };
+    writeStream(stream.size());
+    {
+        RawFrameReader raw;
+        opened = raw.open(path.string());
+        assert(opened);
+        GrayImage img(0, 0);
+        bool got = raw.next(img);
+        assert(got && matches(img, 10, 64, 48, 255));
+        got = raw.next(img);
+        assert(got && matches(img, 11, 33, 17, 4095));
+        got = raw.next(img);
+        assert(got && matches(img, 14, 64, 48, 65535));
+        got = raw.next(img);
+        assert(!got && raw.dropped() == 2);
+    }
+
+    // Truncated samples, a torn descriptor and a foreign stream are errors
+    for (size_t cut : {stream.size() - 1, stream.size() - 64 * 48 * 2 - 3}) {
+        writeStream(cut);
+        RawFrameReader raw;
+        opened = raw.open(path.string());
+        GrayImage img(0, 0);
+        const bool first = raw.next(img), second = raw.next(img), third = raw.next(img);
+        assert(opened && first && second && !third);
+    }
+    stream[0] = 'X';
+    writeStream(stream.size());
+    {
+        RawFrameReader raw;
+        opened = raw.open(path.string());
+        GrayImage img(0, 0);
+        bool got = raw.next(img);
+        assert(opened && !got);
+    }
+    RawFrameReader missing;
+    opened = missing.open((fs::temp_directory_path() / "quasar_missing_raw").string());
+    assert(!opened);
+
+    fs::remove(path);
+    std::cout << "Frame Ingest Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <algorithm>
 #include "huffman.h"
 
 int main() {
@@ -12,7 +13,7 @@ int main() {
     std::cout << "Original: " << testStr << " (" << input.size() << " bytes)" << std::endl;
 
     auto compressed = codec.compress(input);
-    std::cout << "Compressed: " << compressed.size() << " bytes (including 1024B freq table)" << std::endl;
+    std::cout << "Compressed: " << compressed.size() << " bytes (including code-length table)" << std::endl;
 
     auto decompressed = codec.decompress(compressed);
     std::string result(decompressed.begin(), decompressed.end());
@@ -20,6 +21,33 @@ int main() {
     std::cout << "Decompressed: " << result << std::endl;
 
     assert(testStr == result);
+
+    // Fibonacci frequencies force a depth > kMaxCodeLength unconstrained tree
+    std::vector<uint8_t> skewed;
+    uint32_t a = 1, b = 1;
+    for (int sym = 0; sym < 26; ++sym) {
+        skewed.insert(skewed.end(), a, static_cast<uint8_t>(sym));
+        uint32_t next = a + b; a = b; b = next;
+    }
+    assert(codec.decompress(codec.compress(skewed)) == skewed);
+
+    // Single-symbol input still gets a 1-bit code
+    std::vector<uint8_t> flat(1000, 0x42);
+    auto flatCompressed = codec.compress(flat);
+    // 2-byte count + 2-byte table prefix + 18 runs + 125 payload bytes
+    assert(flatCompressed.size() == 2 + 2 + 18 + 125);
+    assert(codec.decompress(flatCompressed) == flat);
+
+    // A truncated stream decodes to a clean prefix, never past the real bits
+    std::vector<uint8_t> longInput;
+    for (int i = 0; i < 20000; ++i) longInput.push_back(static_cast<uint8_t>((i * i) % 61));
+    auto longCompressed = codec.compress(longInput);
+    assert(codec.decompress(longCompressed) == longInput);
+    longCompressed.resize(longCompressed.size() - 100);
+    auto prefix = codec.decompress(longCompressed);
+    assert(prefix.size() < longInput.size());
+    assert(std::equal(prefix.begin(), prefix.end(), longInput.begin()));
+
     std::cout << "Verification SUCCESSFUL!" << std::endl;
 
     return 0;
@@ -0,0 +1,167 @@
+#include "pnm_io.h"
+#include "pixel_kernels.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <cassert>
+
+namespace fs = std::filesystem;
+
+void writeFile(const fs::path& path, const std::string& bytes) {
+    std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size());
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "quasar_test_pnm_io";
+    fs::create_directories(dir);
+
+    // 1. Dispatched kernels are bit-identical to the scalar reference, on
+    // lengths that exercise every vector body and scalar tail
+    const PixelKernels& ref = pixelScalarKernels();
+    const PixelKernels& simd = pixelKernels();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (size_t n : {0u, 1u, 7u, 16u, 31u, 33u, 1000u}) {
+        std::vector<uint8_t> raw(2 * n);
+        for (size_t i = 0; i < raw.size(); ++i) raw[i] = static_cast<uint8_t>(i * 37 + 11);
+        std::vector<float> a(n), b(n);
+        ref.u8ToFloat(raw.data(), a.data(), n);
+        simd.u8ToFloat(raw.data(), b.data(), n);
+        assert(a == b);
+        ref.u16ToFloat(raw.data(), a.data(), n);
+        simd.u16ToFloat(raw.data(), b.data(), n);
+        assert(a == b);
+        ref.u16leToFloat(raw.data(), a.data(), n);
+        simd.u16leToFloat(raw.data(), b.data(), n);
+        assert(a == b);
+
+        // Ties, out-of-range values and NaN
+        std::vector<float> f(n);
+        const float special[] = {-3.0f, 0.5f, 1.5f, 2.5f, 254.5f, 255.5f, 300.0f, 70000.0f, 1e30f, -1e30f, nan, 65534.5f};
+        for (size_t i = 0; i < n; ++i) f[i] = i % 3 ? special[i % 12] : static_cast<float>(i) * 73.31f;
+        std::vector<uint8_t> x(2 * n), y(2 * n);
+        for (float maxVal : {255.0f, 100.0f}) {
+            ref.floatToU8(f.data(), x.data(), n, maxVal);
+            simd.floatToU8(f.data(), y.data(), n, maxVal);
+            assert(x == y);
+        }
+        for (float maxVal : {65535.0f, 4095.0f}) {
+            ref.floatToU16(f.data(), x.data(), n, maxVal);
+            simd.floatToU16(f.data(), y.data(), n, maxVal);
+            assert(x == y);
+        }
+    }
+    float tie[3] = {0.5f, 2.5f, nan};
+    uint8_t rounded[6];
+    simd.floatToU8(tie, rounded, 3, 255.0f);
+    assert(rounded[0] == 0 && rounded[1] == 2 && rounded[2] == 0);
+    simd.floatToU16(tie, rounded, 3, 65535.0f);
+    assert(rounded[1] == 0 && rounded[3] == 2 && rounded[5] == 0);
+    std::cout << "Pixel kernels (" << simd.name << ") match scalar reference" << std::endl;
+
+    // 2. 8-bit P5 with comments in the header, saved and reloaded exactly
+    GrayImage img(0, 0);
+    std::string p5 = "P5\n# made by a test\n3 # width\n2\n255\n";
+    const uint8_t pixels[6] = {0, 1, 127, 128, 254, 255};
+    p5.append(reinterpret_cast<const char*>(pixels), 6);
+    writeFile(dir / "a.pgm", p5);
+    bool ok = loadPGM((dir / "a.pgm").string(), img);
+    assert(ok && img.width == 3 && img.height == 2 && img.maxVal == 255);
+    for (int i = 0; i < 6; ++i) assert(img.data[i] == pixels[i]);
+    ok = savePGM((dir / "b.pgm").string(), img);
+    assert(ok);
+    assert(readFile(dir / "b.pgm") == "P5\n3 2\n255\n" + p5.substr(p5.size() - 6));
+
+    // 3. 16-bit P5 (a thermal sensor), big-endian on disk
+    GrayImage thermal(37, 5);
+    thermal.maxVal = 65535;
+    for (size_t i = 0; i < thermal.data.size(); ++i) thermal.data[i] = static_cast<float>((i * 1777) % 65536);
+    thermal.data[0] = 70000.0f;  // Saturates
+    ok = savePGM((dir / "thermal.pgm").string(), thermal);
+    assert(ok);
+    const std::string raw = readFile(dir / "thermal.pgm");
+    assert(raw.size() == std::string("P5\n37 5\n65535\n").size() + 2 * thermal.data.size());
+    assert(static_cast<uint8_t>(raw[raw.size() - 2]) == ((36 * 5 + 4) * 1777 % 65536) >> 8);
+    ok = loadPGM((dir / "thermal.pgm").string(), img);
+    assert(ok && img.width == 37 && img.height == 5 && img.maxVal == 65535);
+    assert(img.data[0] == 65535.0f);
+    for (size_t i = 1; i < img.data.size(); ++i) assert(img.data[i] == thermal.data[i]);
+
+    // A 12-bit range clamps to its own maxval
+    thermal.maxVal = 4095;
+    ok = savePGM((dir / "thermal12.pgm").string(), thermal);
+    assert(ok);
+    ok = loadPGM((dir / "thermal12.pgm").string(), img);
+    assert(ok && img.maxVal == 4095);
+    for (size_t i = 1; i < img.data.size(); ++i) assert(img.data[i] == std::min(thermal.data[i], 4095.0f));
+
+    // 4. ASCII P2, 8- and 16-bit
+    writeFile(dir / "ascii.pgm", "P2\n# ascii\n4 1 1000\n0 999\n# mid-raster\n1000 5\n");
+    ok = loadPGM((dir / "ascii.pgm").string(), img);
+    assert(ok && img.width == 4 && img.maxVal == 1000);
+    assert(img.data[0] == 0 && img.data[1] == 999 && img.data[2] == 1000 && img.data[3] == 5);
+
+    // 5. Colour is reduced to luma
+    std::string p6 = "P6 2 1 255\n";
+    const uint8_t rgb[6] = {255, 0, 0, 10, 20, 30};
+    p6.append(reinterpret_cast<const char*>(rgb), 6);
+    writeFile(dir / "colour.ppm", p6);
+    ok = loadPGM((dir / "colour.ppm").string(), img);
+    assert(ok && img.width == 2 && img.height == 1);
+    assert(std::fabs(img.data[0] - 0.299f * 255) < 1e-3f);
+    assert(std::fabs(img.data[1] - (0.299f * 10 + 0.587f * 20 + 0.114f * 30)) < 1e-3f);
+    writeFile(dir / "colour_ascii.ppm", "P3 1 1 255 10 20 30");
+    ok = loadPGM((dir / "colour_ascii.ppm").string(), img);
+    assert(ok && std::fabs(img.data[0] - (0.299f * 10 + 0.587f * 20 + 0.114f * 30)) < 1e-3f);
+
+    // 6. Malformed images are rejected
+    const std::string bad[] = {
+        "",
+        "P7\n1 1\n255\n\x01",
+        "P5\n2 2\n255\n\x01\x02\x03",         // Short raster
+        "P5\n2 1\n300\n\x01\x02\x03",         // 16-bit raster short by a byte
+        "P5\n0 1\n255\n",                     // Zero width
+        "P5\n1 1\n70000\n\x01\x02",           // maxval beyond 16 bits
+        "P5\n1 1\n255",                       // No raster separator
+        "P2\n2 1\n15\n3 16\n",                // ASCII sample above maxval
+        "P2\n2 1\n15\n3\n",                   // ASCII raster cut short
+        "P5\n1 x\n255\n\x01",
+    };
+    for (const std::string& bytes : bad) {
+        writeFile(dir / "bad.pgm", bytes);
+        ok = loadPGM((dir / "bad.pgm").string(), img);
+        assert(!ok);
+        std::istringstream in(bytes);
+        ok = readPGM(in, img);
+        assert(!ok);
+    }
+    ok = loadPGM((dir / "missing.pgm").string(), img);
+    assert(!ok);
+
+    // 7. A stream of images, as from a FIFO: mixed formats back to back
+    std::istringstream stream(p5 + "P2 2 1 255 7 8\n" + raw + p6, std::ios::binary);
+    ok = readPGM(stream, img);
+    assert(ok && img.width == 3 && img.data[5] == 255);
+    ok = readPGM(stream, img);
+    assert(ok && img.width == 2 && img.data[1] == 8);
+    ok = readPGM(stream, img);
+    assert(ok && img.width == 37 && img.maxVal == 65535 && img.data[1] == thermal.data[1]);
+    ok = readPGM(stream, img);
+    assert(ok && img.width == 2 && img.maxVal == 255);
+    ok = readPGM(stream, img);
+    assert(!ok);
+
+    fs::remove_all(dir);
+    std::cout << "PNM IO Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
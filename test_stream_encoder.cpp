@@ -0,0 +1,125 @@
+#include "stream_encoder.h"
+#include "spsc_ring.h"
+#include "coeff_codec.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+
+// Synthetic frame `n`: a moving pattern, so consecutive archives differ
+void makeFrame(GrayImage& img, int n) {
+    img.width = 96;
+    img.height = 64;
+    img.data.resize(96 * 64);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 96; ++x) img.data[y * 96 + x] = 128.0f + 100.0f * std::sin((x + n) * 0.3f) * std::cos(y * 0.2f);
+    }
+}
+
+int main() {
+    // 1. SPSC ring: every value arrives exactly once and in order across threads
+    SpscRing<uint64_t> ring(5);
+    assert(ring.capacity() == 8);
+    const uint64_t count = 1000000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count; ++i) {
+            for (int spins = 0; !ring.push(i); ++spins) ringBackoff(spins);
+        }
+    });
+    uint64_t expected = 0, value;
+    for (int spins = 0; expected < count; ++spins) {
+        if (ring.pop(value)) {
+            assert(value == expected);
+            expected++;
+            spins = 0;
+        } else {
+            ringBackoff(spins);
+        }
+    }
+    producer.join();
+    const bool leftover = ring.pop(value);
+    assert(!leftover);
+    std::cout << "SPSC ring: " << count << " values in order" << std::endl;
+
+    // 2. Histogram percentiles land in the right bucket (<= 12.5% high)
+    LatencyHistogram h;
+    for (int us = 1; us <= 1000; ++us) h.record(std::chrono::microseconds(us));
+    assert(h.count() == 1000);
+    assert(h.percentileMicros(50) >= 500 && h.percentileMicros(50) <= 500 * 1.125 + 1);
+    assert(h.percentileMicros(99) >= 990 && h.percentileMicros(100) == 1000);
+    assert(std::abs(h.meanMicros() - 500.5) < 1e-6);
+
+    // 3. The pipeline emits the same archives as the serial path, in order
+    StreamConfig config;
+    config.levels = 3;
+    config.targets = {{48, 32, 20}};
+    config.ringCapacity = 2;
+    const int frames = 50;
+    auto collect = [&](bool pipelined, std::vector<std::vector<uint8_t>>& out) {
+        int n = 0;
+        FrameSource source = [&](GrayImage& img) {
+            if (n == frames) return false;
+            makeFrame(img, n++);
+            return true;
+        };
+        FrameSink sink = [&](const std::vector<uint8_t>& archive) { out.push_back(archive); };
+        StreamEncoder encoder(config);
+        return pipelined ? encoder.run(source, sink) : encoder.runSerial(source, sink);
+    };
+    std::vector<std::vector<uint8_t>> serial, pipelined;
+    StreamStats serialStats = collect(false, serial);
+    StreamStats stats = collect(true, pipelined);
+    assert(serial.size() == frames && pipelined == serial);
+    assert(stats.frames == frames && stats.endToEnd.count() == frames);
+    for (int s = 0; s < StreamStats::kStages; ++s) assert(stats.stage[s].count() == frames);
+    std::cout << "Pipeline: " << stats.frames << " frames identical to serial ("
+              << serialStats.fps() << " -> " << stats.fps() << " fps)" << std::endl;
+
+    // Each archive decodes back to its own frame
+    for (int n = 0; n < frames; n += 7) {
+        QuasarHeader header;
+        std::memcpy(&header, pipelined[n].data(), sizeof(header));
+        assert(header.sequence == static_cast<uint32_t>(n) && header.format_version == kQuasarFormatVersion);
+        std::vector<uint8_t> payload(pipelined[n].begin() + sizeof(header), pipelined[n].end());
+        std::vector<int32_t> coeffs;
+        CoefficientCodec codec;
+        const bool decoded = codec.decode(payload, header.width, header.height, header.wavelet_levels, coeffs);
+        assert(decoded);
+        GrayImage img(header.width, header.height), original(0, 0);
+        dequantizeCoefficients(coeffs, img, header.scale, header.detail_scale, header.wavelet_levels);
+        inverseTransform2D(img, header.wavelet_levels);
+        makeFrame(original, n);
+        // Centre of the ROI survives quantization at scale 10
+        assert(std::abs(img.data[32 * 96 + 48] - original.data[32 * 96 + 48]) < 0.1f);
+    }
+
+    // 4. Encrypted streams: one 8-byte random prefix per run, then the frame
+    // counter, so runs under the same key do not share nonces
+    config.encrypt = true;
+    std::vector<std::vector<uint8_t>> runA, runB;
+    collect(true, runA);
+    collect(true, runB);
+    auto nonce = [](const std::vector<uint8_t>& archive) {
+        QuasarHeader header;
+        std::memcpy(&header, archive.data(), sizeof(header));
+        return std::vector<uint8_t>(header.nonce, header.nonce + 12);
+    };
+    for (int n = 0; n < frames; ++n) {
+        std::vector<uint8_t> a = nonce(runA[n]), b = nonce(runB[n]);
+        assert(std::equal(a.begin(), a.begin() + 8, nonce(runA[0]).begin()));
+        assert(a[8] == n && a[9] == 0 && a[10] == 0 && a[11] == 0);
+        assert(!std::equal(a.begin(), a.begin() + 8, b.begin()));
+    }
+    config.encrypt = false;
+
+    // 5. An empty source ends cleanly
+    StreamEncoder encoder(config);
+    StreamStats empty = encoder.run([](GrayImage&) { return false; }, [](const std::vector<uint8_t>&) { assert(false); });
+    assert(empty.frames == 0);
+
+    std::cout << "Stream Encoder Verification SUCCESSFUL!" << std::endl;
+    return 0;
+}
@@ -1,8 +1,12 @@
 #include "wavelet.h"
+#include "haar_kernels.h"
+#include "quant_kernels.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <cassert>
+#include <algorithm>
+#include <limits>
 
 void printImage(const GrayImage& img, const std::string& label) {
     std::cout << "--- " << label << " ---" << std::endl;
@@ -35,7 +39,7 @@ int main() {
 
     // 2. Quantize/Dequantize bridge
     auto quantized = quantize(img, scale);
-    std::cout << "Quantized size: " << quantized.size() << " bytes (4 per pixel)" << std::endl;
+    std::cout << "Quantized size: " << quantized.size() << " bytes (bit-packed, " << N * N * 4 << " unpacked)" << std::endl;
     
     GrayImage reconstructed(N, N);
     dequantize(quantized, reconstructed, scale);
@@ -59,5 +63,94 @@ int main() {
         std::cout << "RESULT: FAILED (Error too high)" << std::endl;
     }
 
+    // 5. Multi-level pyramid on a non-square frame with odd sub-band sizes
+    const int W = 88, H = 52, levels = 3;
+    GrayImage pyramid(W, H);
+    for (int i = 0; i < W * H; ++i) {
+        pyramid.data[i] = static_cast<float>((i * 37) % 251);
+    }
+    GrayImage pyramidOriginal = pyramid;
+    transform2D(pyramid, levels);
+    inverseTransform2D(pyramid, levels);
+
+    float pyramidError = 0.0f;
+    for (int i = 0; i < W * H; ++i) {
+        pyramidError = std::max(pyramidError, std::abs(pyramid.data[i] - pyramidOriginal.data[i]));
+    }
+    std::cout << "Multi-level (" << levels << ") Reconstruction Error: " << pyramidError << std::endl;
+    assert(pyramidError < 0.001f);
+
+    // 6. Dispatched SIMD kernels must be bit-identical to the scalar reference
+    const HaarKernels& ref = haarScalarKernels();
+    const HaarKernels& simd = haarKernels();
+    const int n = 37; // exercises vector body and scalar tail
+    std::vector<float> line(2 * n), lo1(n), hi1(n), lo2(n), hi2(n), out1(2 * n), out2(2 * n);
+    for (int i = 0; i < 2 * n; ++i) line[i] = std::sin(i * 0.7f) * 100.0f;
+    ref.forwardRow(line.data(), lo1.data(), hi1.data(), n);
+    simd.forwardRow(line.data(), lo2.data(), hi2.data(), n);
+    assert(lo1 == lo2 && hi1 == hi2);
+    ref.inverseRow(lo1.data(), hi1.data(), out1.data(), n);
+    simd.inverseRow(lo1.data(), hi1.data(), out2.data(), n);
+    assert(out1 == out2);
+    ref.forwardPair(line.data(), line.data() + n, lo1.data(), hi1.data(), n);
+    simd.forwardPair(line.data(), line.data() + n, lo2.data(), hi2.data(), n);
+    assert(lo1 == lo2 && hi1 == hi2);
+    ref.inversePair(lo1.data(), hi1.data(), out1.data(), out1.data() + n, n);
+    simd.inversePair(lo1.data(), hi1.data(), out2.data(), out2.data() + n, n);
+    assert(out1 == out2);
+    std::cout << "Kernels (" << simd.name << ") match scalar reference" << std::endl;
+
+    // 7. Quantization kernels: ties, saturation and NaN behave identically
+    const QuantKernels& qref = quantScalarKernels();
+    const QuantKernels& qsimd = quantKernels();
+    std::vector<float> vals = {0.5f, 1.5f, 2.5f, -0.5f, -1.5f, -2.5f, 3e9f, -3e9f,
+                               std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN()};
+    for (int i = 0; i < 27; ++i) vals.push_back(std::sin(i * 1.3f) * 40000.0f);
+    const int qn = static_cast<int>(vals.size());
+    std::vector<int32_t> q1(qn), q2(qn);
+    qref.quantize(vals.data(), q1.data(), qn, 1.0f);
+    qsimd.quantize(vals.data(), q2.data(), qn, 1.0f);
+    assert(q1 == q2);
+    assert(q1[0] == 0 && q1[1] == 2 && q1[2] == 2 && q1[5] == -2); // half to even
+    assert(q1[6] == 2147483520 && q1[7] == -2147483520 && q1[9] == -2147483520);
+    std::vector<float> d1(qn), d2(qn);
+    qref.dequantize(q1.data(), d1.data(), qn, 0.001f);
+    qsimd.dequantize(q1.data(), d2.data(), qn, 0.001f);
+    assert(d1 == d2);
+    std::cout << "Quantization kernels (" << qsimd.name << ") match scalar reference" << std::endl;
+
+    // 8. ROI span masks match the per-pixel disc test, and wavelet-domain
+    //    saliency leaves every ROI pixel untouched
+    const std::vector<ROI> rois = {{20, 15, 9}, {30, 20, 6}, {80, 50, 12}};
+    SpanMask mask = buildRoiMask(rois, W, H, 0);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            bool brute = false;
+            for (const ROI& r : rois) brute |= (x - r.x) * (x - r.x) + (y - r.y) * (y - r.y) <= r.r * r.r;
+            bool spans = false;
+            for (uint32_t s = mask.rowStart[y]; s < mask.rowStart[y + 1]; ++s) {
+                spans |= x >= mask.spans[s].first && x < mask.spans[s].second;
+            }
+            assert(brute == spans);
+        }
+    }
+    GrayImage masked = pyramid;
+    transform2D(masked, levels);
+    applySubbandSaliency(masked, rois, levels);
+    inverseTransform2D(masked, levels);
+    int background = 0;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            bool inRoi = false;
+            for (const ROI& r : rois) inRoi |= (x - r.x) * (x - r.x) + (y - r.y) * (y - r.y) <= r.r * r.r;
+            float err = std::abs(masked.data[y * W + x] - pyramid.data[y * W + x]);
+            if (inRoi) assert(err < 0.001f);
+            else background += masked.data[y * W + x] == 0.0f;
+        }
+    }
+    assert(background > W * H / 2);
+    std::cout << "Subband saliency keeps ROIs exact (" << background << " background pixels cleared)" << std::endl;
+
     return 0;
 }
@@ -0,0 +1,72 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace {
+// Set while a thread is executing loop bodies, to run nested loops inline
+thread_local bool insideLoop = false;
+}
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+void ThreadPool::runIndices() {
+    insideLoop = true;
+    for (size_t i = next.fetch_add(1); i < jobSize; i = next.fetch_add(1)) (*job)(i);
+    insideLoop = false;
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runIndices();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--active == 0) finished.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn) {
+    if (n == 0) return;
+    if (insideLoop || workers.empty() || n == 1) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobSize = n;
+        next.store(0);
+        active = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    runIndices();
+
+    // fn must outlive every worker's last index, so wait for all of them
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return active == 0; });
+    job = nullptr;
+}
+
+ThreadPool& defaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
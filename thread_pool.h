@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed pool of worker threads for data-parallel loops.
+ *
+ * parallelFor(n, fn) runs fn(0) .. fn(n - 1) spread over the workers and the
+ * calling thread, and returns once every call has finished. Indices are
+ * handed out one at a time from a shared counter, so uneven work (a busy ROI
+ * tile next to an empty one) balances itself. A call made from inside a
+ * running loop executes inline on that thread instead of deadlocking.
+ */
+class ThreadPool {
+public:
+    // threads = 0 sizes the pool to the hardware (the caller counts as one)
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that execute a loop, including the caller
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+
+private:
+    void workerLoop();
+    void runIndices();
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;              // One loop at a time per pool
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobSize = 0;
+    std::atomic<size_t> next{0};
+    size_t active = 0;                   // Workers still inside the current loop
+    uint64_t generation = 0;
+    bool stopping = false;
+};
+
+// Process-wide pool shared by the tile coder
+ThreadPool& defaultThreadPool();
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,117 @@
+#include "tile_codec.h"
+#include "coeff_codec.h"
+#include "varint.h"
+#include <algorithm>
+#include <atomic>
+
+std::vector<TileRect> tileLayout(int width, int height, int tileSize) {
+    std::vector<TileRect> tiles;
+    if (width <= 0 || height <= 0 || tileSize <= 0) return tiles;
+    for (int y = 0; y < height; y += tileSize) {
+        for (int x = 0; x < width; x += tileSize) {
+            tiles.push_back({x, y, std::min(tileSize, width - x), std::min(tileSize, height - y)});
+        }
+    }
+    return tiles;
+}
+
+bool tileTouchesRois(const TileRect& tile, const std::vector<ROI>& targets, int levels, float falloff) {
+    if (targets.empty()) return true;
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(tile.width, tile.height)));
+    // Every subband of level l is masked with the level-l grid
+    for (int l = 1; l <= levels; ++l) {
+        SpanMask mask = buildRoiMask(targets, tile.width, tile.height, l, std::max(falloff, 0.0f), tile.x, tile.y);
+        if (!mask.spans.empty()) return true;
+    }
+    return false;
+}
+
+size_t TileIndex::skipped() const {
+    return static_cast<size_t>(std::count(sizes.begin(), sizes.end(), size_t{0}));
+}
+
+std::vector<uint8_t> encodeTiles(const GrayImage& img, const std::vector<ROI>& targets, const TileCoding& coding,
+                                 ThreadPool& pool) {
+    const int tileSize = std::clamp(coding.tileSize, 1, 65535);
+    const std::vector<TileRect> tiles = tileLayout(img.width, img.height, tileSize);
+    std::vector<std::vector<uint8_t>> streams(tiles.size());
+
+    pool.parallelFor(tiles.size(), [&](size_t i) {
+        const TileRect& t = tiles[i];
+        if (!tileTouchesRois(t, targets, coding.levels, coding.falloff)) return;
+
+        GrayImage tile(t.width, t.height);
+        for (int y = 0; y < t.height; ++y) {
+            const float* src = img.data.data() + static_cast<size_t>(t.y + y) * img.width + t.x;
+            std::copy(src, src + t.width, tile.data.begin() + static_cast<size_t>(y) * t.width);
+        }
+        transform2D(tile, coding.levels);
+        applySubbandSaliency(tile, targets, coding.levels, coding.falloff, t.x, t.y);
+        std::vector<int32_t> coeffs = quantizeCoefficients(tile, coding.scale, coding.detailScale, coding.levels);
+        CoefficientCodec codec;
+        streams[i] = codec.encode(coeffs, t.width, t.height, coding.levels);
+    });
+
+    std::vector<uint8_t> output;
+    writeVarint(static_cast<uint64_t>(tileSize), output);
+    size_t total = 0;
+    for (const auto& s : streams) {
+        writeVarint(s.size(), output);
+        total += s.size();
+    }
+    output.reserve(output.size() + total);
+    for (const auto& s : streams) output.insert(output.end(), s.begin(), s.end());
+    return output;
+}
+
+bool readTileIndex(std::span<const uint8_t> data, int width, int height, TileIndex& index) {
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    uint64_t tileSize = 0;
+    if (!readVarint(p, end, tileSize) || tileSize == 0 || tileSize > 65535) return false;
+
+    index.tileSize = static_cast<int>(tileSize);
+    index.tiles = tileLayout(width, height, index.tileSize);
+    index.sizes.resize(index.tiles.size());
+    index.offsets.resize(index.tiles.size());
+    for (size_t& size : index.sizes) {
+        uint64_t v = 0;
+        if (!readVarint(p, end, v) || v > data.size()) return false;
+        size = static_cast<size_t>(v);
+    }
+    size_t offset = static_cast<size_t>(p - data.data());
+    for (size_t i = 0; i < index.tiles.size(); ++i) {
+        if (index.sizes[i] > data.size() - offset) return false;
+        index.offsets[i] = offset;
+        offset += index.sizes[i];
+    }
+    return offset == data.size();
+}
+
+bool decodeTiles(std::span<const uint8_t> data, int levels, float scale, float detailScale, GrayImage& img,
+                 ThreadPool& pool) {
+    TileIndex index;
+    if (!readTileIndex(data, img.width, img.height, index)) return false;
+    img.data.resize(static_cast<size_t>(img.width) * img.height);
+
+    std::atomic<bool> ok{true};
+    pool.parallelFor(index.tiles.size(), [&](size_t i) {
+        const TileRect& t = index.tiles[i];
+        GrayImage tile(t.width, t.height);
+        if (index.sizes[i] > 0) {
+            std::vector<int32_t> coeffs;
+            CoefficientCodec codec;
+            if (!codec.decode(data.subspan(index.offsets[i], index.sizes[i]), t.width, t.height, levels, coeffs)) {
+                ok = false;
+                return;
+            }
+            dequantizeCoefficients(coeffs, tile, scale, detailScale, levels);
+            inverseTransform2D(tile, levels);
+        }
+        for (int y = 0; y < t.height; ++y) {
+            const float* src = tile.data.data() + static_cast<size_t>(y) * t.width;
+            std::copy(src, src + t.width, img.data.begin() + static_cast<size_t>(t.y + y) * img.width + t.x);
+        }
+    });
+    return ok;
+}
@@ -0,0 +1,70 @@
+#ifndef TILE_CODEC_H
+#define TILE_CODEC_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include "quasar_format.h"
+#include "wavelet.h"
+#include "thread_pool.h"
+
+/**
+ * Tiled coefficient coding.
+ *
+ * The frame is cut into tileSize x tileSize tiles (smaller at the right and
+ * bottom edges). Each tile is transformed, saliency-masked, quantized and
+ * coefficient-coded on its own, so tiles run in parallel on a thread pool at
+ * both ends of the link. A tile that no ROI reaches (after falloff and the
+ * coarsest coefficient footprint) would be masked to all zeros, so it is not
+ * transformed or coded at all and costs one index byte.
+ *
+ * Payload (flag 0x08, together with 0x04 | 0x02):
+ *
+ *   varint tileSize
+ *   varint byte count of every tile in raster order (0 = skipped, all zero)
+ *   the tiles' CoefficientCodec streams, back to back
+ */
+struct TileRect {
+    int x, y;
+    int width, height;
+};
+
+// Tiles covering a width x height frame in raster order
+std::vector<TileRect> tileLayout(int width, int height, int tileSize);
+
+// False if saliency masking would zero every coefficient of the tile.
+// Always true without ROIs (nothing is masked).
+bool tileTouchesRois(const TileRect& tile, const std::vector<ROI>& targets, int levels, float falloff = 0.0f);
+
+struct TileCoding {
+    int tileSize = 256;
+    int levels = 3;
+    float scale = 10.0f;
+    float detailScale = 0.0f;
+    float falloff = 0.0f;
+};
+
+// Parsed tile index of a payload
+struct TileIndex {
+    int tileSize = 0;
+    std::vector<TileRect> tiles;
+    std::vector<size_t> offsets;  // Start of each tile's stream in the payload
+    std::vector<size_t> sizes;    // 0 for skipped tiles
+
+    size_t skipped() const;
+};
+
+// Encodes the spatial-domain frame `img` (not modified)
+std::vector<uint8_t> encodeTiles(const GrayImage& img, const std::vector<ROI>& targets, const TileCoding& coding,
+                                 ThreadPool& pool = defaultThreadPool());
+
+// Reads the index and checks that it covers the frame and the payload.
+bool readTileIndex(std::span<const uint8_t> data, int width, int height, TileIndex& index);
+
+// Reconstructs the frame into `img`, whose width/height must be set (data is
+// resized). Returns false if the index or any tile stream is malformed.
+bool decodeTiles(std::span<const uint8_t> data, int levels, float scale, float detailScale, GrayImage& img,
+                 ThreadPool& pool = defaultThreadPool());
+
+#endif // TILE_CODEC_H
@@ -1,8 +1,12 @@
 #include "udp_link.h"
+#include "fec.h"
 #include <iostream>
 #include <cstring>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <random>
 
 #ifdef _WIN32
     #include <winsock2.h>
@@ -14,16 +18,31 @@
     #include <netinet/in.h>
     #include <arpa/inet.h>
     #include <unistd.h>
+    #include <sys/uio.h>
     typedef int SOCKET;
     #define INVALID_SOCKET -1
     #define SOCKET_ERROR -1
     #define closesocket close
 #endif
 
-// Portable Sleep
-void tiny_sleep(int us) {
-    std::this_thread::sleep_for(std::chrono::microseconds(us));
-}
+#if defined(__linux__)
+    #include <netinet/udp.h>
+    #ifndef UDP_SEGMENT
+    #define UDP_SEGMENT 103
+    #endif
+    #ifndef SOL_UDP
+    #define SOL_UDP 17
+    #endif
+#endif
+
+// Datagrams handed to one sendmmsg call
+constexpr size_t kSendBatch = 64;
+
+// Datagrams pulled by one recvmmsg call
+constexpr size_t kRecvBatch = 64;
+
+// Largest GSO super-datagram: whole chunks within the 65507-byte UDP limit
+constexpr size_t kGsoSegments = 65507 / sizeof(QuasarPacket);
 
 // Global Networking Init (for Windows)
 struct NetworkEnv {
@@ -41,46 +60,442 @@ struct NetworkEnv {
 };
 static NetworkEnv _env;
 
+// --- Pacing ---
+void TokenBucket::configure(uint64_t bytes_per_second, size_t burst_bytes) {
+    rate = static_cast<double>(bytes_per_second);
+    burst = static_cast<double>(burst_bytes);
+    tokens = burst;
+    last = std::chrono::steady_clock::now();
+}
+
+void TokenBucket::acquire(size_t bytes) {
+    if (rate <= 0.0) return;
+    auto now = std::chrono::steady_clock::now();
+    tokens = std::min(burst, tokens + std::chrono::duration<double>(now - last).count() * rate);
+    last = now;
+    tokens -= static_cast<double>(bytes);
+    if (tokens < 0.0) {
+        // Sleep off the debt; the next refill accounts for any oversleep
+        std::this_thread::sleep_for(std::chrono::duration<double>(-tokens / rate));
+    }
+}
+
 // --- Transmitter ---
-QuasarTx::QuasarTx() : frame_counter(0) {
+QuasarTx::QuasarTx() : frame_counter(std::random_device{}()) {
     sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    set_pacing(100000000); // 100 Mbit/s
 }
 
 QuasarTx::~QuasarTx() {
     if (sock != INVALID_SOCKET) closesocket(sock);
 }
 
+void QuasarTx::set_pacing(uint64_t bits_per_second, size_t burst_bytes) {
+    pacer.configure(bits_per_second / 8, burst_bytes);
+}
+
+bool QuasarTx::set_gso(bool enable) {
+#if defined(__linux__)
+    int segment = enable ? static_cast<int>(sizeof(QuasarPacket)) : 0;
+    if (setsockopt(sock, SOL_UDP, UDP_SEGMENT, &segment, sizeof(segment)) == 0) {
+        gso = enable;
+        return true;
+    }
+#endif
+    gso = false;
+    return !enable;
+}
+
+bool QuasarTx::set_fec(int data, int parity) {
+    if (data == 0 && parity == 0) {
+        fec_k = fec_m = 0;
+        return true;
+    }
+    if (data < 1 || data > 255 || parity < 0 || parity > 255 || data + parity > 256) return false;
+    fec_k = static_cast<uint8_t>(data);
+    fec_m = static_cast<uint8_t>(parity);
+    return true;
+}
+
 void QuasarTx::send_frame(const std::vector<uint8_t>& full_data, const std::string& ip, int port) {
+    send_frame(full_data, {}, {}, ip, port);
+}
+
+void QuasarTx::send_frame(std::span<const uint8_t> head, std::span<const uint8_t> body, std::span<const uint8_t> tail,
+                          const std::string& ip, int port) {
     sockaddr_in target;
+    std::memset(&target, 0, sizeof(target));
     target.sin_family = AF_INET;
     target.sin_port = htons(port);
     inet_pton(AF_INET, ip.c_str(), &target.sin_addr);
 
-    uint16_t total_chunks = (full_data.size() + 1399) / 1400;
+    const std::span<const uint8_t> pieces[3] = {head, body, tail};
+    const size_t frame_size = head.size() + body.size() + tail.size();
+    const size_t data_chunks = (frame_size + kChunkPayload - 1) / kChunkPayload;
+    const size_t groups = fec_k ? (data_chunks + fec_k - 1) / fec_k : 0;
+    const size_t parity_chunks = groups * fec_m;
+    if (data_chunks + parity_chunks > 0xffff) {
+        std::cerr << "[Tx] Frame too large (" << data_chunks << " chunks + " << parity_chunks << " parity), not sent" << std::endl;
+        return;
+    }
+    const uint16_t total_chunks = static_cast<uint16_t>(data_chunks);
+    const size_t chunks = data_chunks + parity_chunks;
+    const size_t last_size = frame_size - (data_chunks ? (data_chunks - 1) * kChunkPayload : 0);
     frame_counter++;
 
+    // Chunk headers live in one array; payloads stay in the caller's buffers,
+    // except for the (at most two) chunks that span a piece boundary, which
+    // are gathered into `straddle`
+    headers.resize(chunks);
+    chunk_data.resize(data_chunks);
+    straddle.resize(2 * kChunkPayload);
+    size_t piece = 0, piece_start = 0, staged = 0;
     for (uint16_t i = 0; i < total_chunks; ++i) {
+        const size_t begin = static_cast<size_t>(i) * kChunkPayload;
+        const size_t size = std::min(frame_size - begin, kChunkPayload);
+        headers[i] = {kChunkVersion, frame_counter, i, total_chunks, static_cast<uint16_t>(size), fec_k, fec_m};
+        while (piece_start + pieces[piece].size() <= begin) piece_start += pieces[piece++].size();
+        if (begin + size <= piece_start + pieces[piece].size()) {
+            chunk_data[i] = pieces[piece].data() + (begin - piece_start);
+            continue;
+        }
+        uint8_t* dst = straddle.data() + staged++ * kChunkPayload;
+        for (size_t copied = 0, p = piece, start = piece_start; copied < size; start += pieces[p++].size()) {
+            const size_t offset = begin + copied - start;
+            const size_t n = std::min(size - copied, pieces[p].size() - offset);
+            if (n) std::memcpy(dst + copied, pieces[p].data() + offset, n);
+            copied += n;
+        }
+        chunk_data[i] = dst;
+    }
+
+    // Parity chunks follow all the data, group by group
+    parity.resize(parity_chunks * kChunkPayload);
+    for (size_t g = 0; g < groups; ++g) {
+        const size_t first = g * fec_k;
+        const int k = static_cast<int>(std::min<size_t>(fec_k, data_chunks - first));
+        const uint8_t* data[256];
+        size_t sizes[256];
+        uint8_t* out[256];
+        for (int j = 0; j < k; ++j) {
+            data[j] = chunk_data[first + j];
+            sizes[j] = headers[first + j].data_size;
+        }
+        for (int r = 0; r < fec_m; ++r) {
+            size_t n = g * fec_m + r;
+            out[r] = parity.data() + n * kChunkPayload;
+            headers[data_chunks + n] = {kChunkVersion, frame_counter, static_cast<uint16_t>(data_chunks + n), total_chunks,
+                                        static_cast<uint16_t>(last_size), fec_k, fec_m};
+        }
+        fecEncode(data, sizes, k, out, fec_m, kChunkPayload);
+    }
+    auto payload = [&](size_t i) -> const uint8_t* {
+        return i < data_chunks ? chunk_data[i] : parity.data() + (i - data_chunks) * kChunkPayload;
+    };
+    auto payload_size = [&](size_t i) { return i < data_chunks ? headers[i].data_size : kChunkPayload; };
+    size_t syscalls = 0;
+
+#if defined(_WIN32)
+    // Portable path: one sendto per chunk through a stack packet
+    for (size_t i = 0; i < chunks; ++i) {
         QuasarPacket pkt;
-        pkt.frame_id = frame_counter;
-        pkt.chunk_id = i;
-        pkt.total_chunks = total_chunks;
-        
-        uint32_t offset = i * 1400;
-        uint32_t remaining = full_data.size() - offset;
-        pkt.data_size = (remaining > 1400) ? 1400 : (uint16_t)remaining;
-        
-        std::memcpy(pkt.payload, full_data.data() + offset, pkt.data_size);
+        std::memcpy(&pkt, &headers[i], sizeof(QuasarChunkHeader));
+        std::memcpy(pkt.payload, payload(i), payload_size(i));
+        size_t len = sizeof(QuasarChunkHeader) + payload_size(i);
+        pacer.acquire(len);
+        sendto(sock, (const char*)&pkt, static_cast<int>(len), 0, (sockaddr*)&target, sizeof(target));
+        syscalls++;
+    }
+#else
+    // Every chunk is two iovecs: its header, then its payload (a slice of the
+    // frame or a parity buffer). A message carries one chunk, or with GSO up
+    // to kGsoSegments chunks that the kernel splits back into individual
+    // datagrams; only a message's last segment may be short, so a short chunk
+    // ends its message.
+    iov.resize(2 * chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        iov[2 * i] = {&headers[i], sizeof(QuasarChunkHeader)};
+        iov[2 * i + 1] = {const_cast<uint8_t*>(payload(i)), payload_size(i)};
+    }
+
+#if defined(__linux__)
+    const size_t per_message = gso ? kGsoSegments : 1;
+    msgs.clear();
+    message_bytes.clear();
+    for (size_t first = 0; first < chunks;) {
+        size_t count = 0, bytes = 0;
+        while (first + count < chunks && count < per_message) {
+            size_t size = payload_size(first + count++);
+            bytes += sizeof(QuasarChunkHeader) + size;
+            if (size < kChunkPayload) break;
+        }
+        mmsghdr m;
+        std::memset(&m, 0, sizeof(m));
+        m.msg_hdr.msg_name = &target;
+        m.msg_hdr.msg_namelen = sizeof(target);
+        m.msg_hdr.msg_iov = &iov[2 * first];
+        m.msg_hdr.msg_iovlen = 2 * count;
+        msgs.push_back(m);
+        message_bytes.push_back(bytes);
+        first += count;
+    }
+    const size_t messages = msgs.size();
+
+    // Messages [0, paid) have been charged to the pacer; a partial send or a
+    // retry resubmits them without paying again
+    size_t sent = 0, paid = 0;
+    while (sent < messages) {
+        size_t batch = std::min(kSendBatch, messages - sent);
+        size_t bytes = 0;
+        for (; paid < sent + batch; ++paid) bytes += message_bytes[paid];
+        if (bytes) pacer.acquire(bytes);
+        int n = sendmmsg(sock, &msgs[sent], static_cast<unsigned>(batch), 0);
+        syscalls++;
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (errno == ENOBUFS || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            // Socket buffer full: back off briefly and resubmit
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        } else {
+            std::cerr << "[Tx] sendmmsg failed (errno " << errno << "), frame truncated" << std::endl;
+            break;
+        }
+    }
+#else
+    // Other POSIX systems: sendmsg per message, still without copying
+    for (size_t m = 0; m < chunks; ++m) {
+        msghdr h;
+        std::memset(&h, 0, sizeof(h));
+        h.msg_name = &target;
+        h.msg_namelen = sizeof(target);
+        h.msg_iov = &iov[2 * m];
+        h.msg_iovlen = 2;
+        pacer.acquire(sizeof(QuasarChunkHeader) + payload_size(m));
+        sendmsg(sock, &h, 0);
+        syscalls++;
+    }
+#endif
+#endif
+    std::cout << "[Tx] Sent Frame " << frame_counter << " (" << total_chunks << " chunks";
+    if (parity_chunks) std::cout << " + " << parity_chunks << " parity";
+    std::cout << ", " << syscalls << " send calls)" << std::endl;
+}
+
+std::string Peer::to_string() const {
+    return std::to_string(ip >> 24) + "." + std::to_string((ip >> 16) & 0xFF) + "." + std::to_string((ip >> 8) & 0xFF) + "." +
+           std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+}
+
+// --- Reassembly ---
+FrameReassembler::FrameReassembler(size_t max_frames, std::chrono::milliseconds max_age, size_t max_frame_bytes,
+                                   size_t max_total_bytes)
+    : slots(std::max<size_t>(1, max_frames)), max_age(max_age), max_frame_bytes(std::min(max_frame_bytes, max_total_bytes)),
+      max_total_bytes(max_total_bytes) {}
+
+bool FrameReassembler::recently_completed(uint64_t source, uint32_t frame_id, std::chrono::steady_clock::time_point now) const {
+    for (const Completed& c : completed) {
+        if (c.valid && c.source == source && c.frame_id == frame_id && now - c.when < max_age) return true;
+    }
+    return false;
+}
+
+// Bytes a slot's slabs hold, whether or not a frame is using them
+static size_t slab_bytes(const std::vector<uint8_t>& data, const std::vector<uint8_t>& parity) {
+    return data.capacity() + parity.capacity();
+}
+
+static void release_slabs(std::vector<uint8_t>& data, std::vector<uint8_t>& parity) {
+    std::vector<uint8_t>().swap(data);
+    std::vector<uint8_t>().swap(parity);
+}
+
+void FrameReassembler::evict(Slot& slot) {
+    counters.frames_evicted++;
+    counters.chunks_lost += slot.total_chunks - slot.received;
+    slot.active = false;
+    if (slab_bytes(slot.data, slot.parity) > max_total_bytes / slots.size()) release_slabs(slot.data, slot.parity);
+}
 
-        sendto(sock, (const char*)&pkt, sizeof(pkt) - (1400 - pkt.data_size), 0, (sockaddr*)&target, sizeof(target));
-        
-        // Rate limiting to prevent buffer overflow
-        tiny_sleep(100);
+void FrameReassembler::make_room(Slot& slot, size_t bytes) {
+    if (slab_bytes(slot.data, slot.parity) > std::max(bytes, max_total_bytes / slots.size())) release_slabs(slot.data, slot.parity);
+    size_t others = 0;
+    for (const Slot& s : slots) {
+        if (&s != &slot) others += slab_bytes(s.data, s.parity);
     }
-    std::cout << "[Tx] Sent Frame " << frame_counter << " (" << total_chunks << " chunks)" << std::endl;
+    // bytes <= max_frame_bytes <= max_total_bytes, so this ends at the latest
+    // once every other slab is gone
+    while (others + std::max(bytes, slab_bytes(slot.data, slot.parity)) > max_total_bytes) {
+        Slot* victim = nullptr;
+        for (Slot& s : slots) {
+            if (&s == &slot || slab_bytes(s.data, s.parity) == 0) continue;
+            if (!victim || (victim->active && (!s.active || s.last_seen < victim->last_seen))) victim = &s;
+        }
+        if (!victim) break;
+        others -= slab_bytes(victim->data, victim->parity);
+        if (victim->active) evict(*victim);
+        release_slabs(victim->data, victim->parity);
+    }
+}
+
+void FrameReassembler::expire(std::chrono::steady_clock::time_point now) {
+    for (Slot& slot : slots) {
+        if (slot.active && now - slot.last_seen > max_age) evict(slot);
+    }
+}
+
+// Number of FEC groups and parity chunks of a frame
+static size_t fec_groups(const QuasarChunkHeader& h) {
+    return h.fec_k ? (h.total_chunks + h.fec_k - 1) / h.fec_k : 0;
+}
+
+FrameReassembler::Slot& FrameReassembler::slot_for(uint64_t source, const QuasarChunkHeader& h, std::chrono::steady_clock::time_point now) {
+    Slot* free_slot = nullptr;
+    Slot* lru = nullptr;
+    for (Slot& slot : slots) {
+        if (slot.active && slot.frame_id == h.frame_id && slot.source == source) return slot;
+        if (!slot.active) {
+            if (!free_slot) free_slot = &slot;
+        } else if (!lru || slot.last_seen < lru->last_seen) {
+            lru = &slot;
+        }
+    }
+    if (!free_slot) {
+        evict(*lru);
+        free_slot = lru;
+    }
+
+    // resize/assign keep the slabs' capacity, so reuse does not allocate
+    const size_t groups = fec_groups(h);
+    const size_t chunks = h.total_chunks + groups * h.fec_m;
+    Slot& slot = *free_slot;
+    make_room(slot, chunks * kChunkPayload);
+    slot.active = true;
+    slot.source = source;
+    slot.frame_id = h.frame_id;
+    slot.total_chunks = h.total_chunks;
+    slot.received = 0;
+    slot.fec_k = h.fec_k;
+    slot.fec_m = h.fec_m;
+    slot.last_chunk_size = 0;
+    slot.data.resize(static_cast<size_t>(h.total_chunks) * kChunkPayload);
+    slot.parity.resize(groups * h.fec_m * kChunkPayload);
+    slot.arrived.assign((chunks + 63) / 64, 0);
+    slot.group_have.assign(groups, 0);
+    slot.last_seen = now;
+    return slot;
+}
+
+void FrameReassembler::recover_group(Slot& slot, size_t group) {
+    const size_t first = group * slot.fec_k;
+    const int k = static_cast<int>(std::min<size_t>(slot.fec_k, slot.total_chunks - first));
+    const int m = slot.fec_m;
+    auto has = [&](size_t chunk) { return (slot.arrived[chunk / 64] >> (chunk % 64)) & 1; };
+
+    uint8_t* data[256];
+    uint8_t* parity[256];
+    bool data_present[256], parity_present[256];
+    int missing = 0;
+    for (int j = 0; j < k; ++j) {
+        data[j] = slot.data.data() + (first + j) * kChunkPayload;
+        data_present[j] = has(first + j);
+        missing += !data_present[j];
+    }
+    if (missing == 0 || slot.group_have[group] < k) return;
+    for (int r = 0; r < m; ++r) {
+        size_t n = group * m + r;
+        parity[r] = slot.parity.data() + n * kChunkPayload;
+        parity_present[r] = has(slot.total_chunks + n);
+    }
+    if (!fecRecover(data, data_present, k, parity, parity_present, m, kChunkPayload)) return;
+
+    for (int j = 0; j < k; ++j) {
+        size_t chunk = first + j;
+        slot.arrived[chunk / 64] |= 1ull << (chunk % 64);
+    }
+    slot.received += static_cast<uint16_t>(missing);
+    counters.chunks_recovered += missing;
+}
+
+bool FrameReassembler::add(const uint8_t* datagram, size_t len, std::vector<uint8_t>& out, std::chrono::steady_clock::time_point now,
+                           uint64_t source) {
+    expire(now);
+
+    QuasarChunkHeader h;
+    if (len < sizeof(h)) {
+        counters.malformed++;
+        return false;
+    }
+    std::memcpy(&h, datagram, sizeof(h));
+    const size_t payload_len = len - sizeof(h);
+    const size_t parity_chunks = fec_groups(h) * h.fec_m;
+    const bool is_parity = h.chunk_id >= h.total_chunks;
+    const bool last = h.chunk_id + 1 == h.total_chunks;
+    const bool bad_fec = h.fec_k ? h.fec_k + h.fec_m > 256 : h.fec_m != 0;
+    const bool bad_size = is_parity ? payload_len < kChunkPayload || h.data_size == 0
+                                    : h.data_size > payload_len || (!last && h.data_size != kChunkPayload);
+    if (h.version != kChunkVersion || h.total_chunks == 0 || bad_fec || h.chunk_id >= h.total_chunks + parity_chunks || bad_size ||
+        h.data_size > kChunkPayload || (h.total_chunks + parity_chunks) * kChunkPayload > max_frame_bytes) {
+        counters.malformed++;
+        return false;
+    }
+    if (recently_completed(source, h.frame_id, now)) {
+        // Parity for a frame that completed without it is expected, not a repeat
+        if (!is_parity) counters.duplicates++;
+        return false;
+    }
+
+    Slot& slot = slot_for(source, h, now);
+    if (slot.total_chunks != h.total_chunks || slot.fec_k != h.fec_k || slot.fec_m != h.fec_m) {
+        counters.malformed++;
+        return false;
+    }
+    uint64_t& word = slot.arrived[h.chunk_id / 64];
+    const uint64_t bit = 1ull << (h.chunk_id % 64);
+    if (word & bit) {
+        // A data chunk already rebuilt from parity is not a repeat either
+        if (!(slot.fec_k && !is_parity)) counters.duplicates++;
+        return false;
+    }
+    word |= bit;
+    slot.last_seen = now;
+    counters.packets++;
+
+    size_t group;
+    if (is_parity) {
+        size_t n = h.chunk_id - h.total_chunks;
+        group = n / h.fec_m;
+        std::memcpy(slot.parity.data() + n * kChunkPayload, datagram + sizeof(h), kChunkPayload);
+        slot.last_chunk_size = h.data_size;
+    } else {
+        // Straight to the chunk's final offset in the slab
+        uint8_t* dst = slot.data.data() + static_cast<size_t>(h.chunk_id) * kChunkPayload;
+        std::memcpy(dst, datagram + sizeof(h), h.data_size);
+        if (last) {
+            // Zero padded, as the parity was computed over it
+            std::memset(dst + h.data_size, 0, kChunkPayload - h.data_size);
+            slot.last_chunk_size = h.data_size;
+        }
+        slot.received++;
+        group = h.fec_k ? h.chunk_id / h.fec_k : 0;
+    }
+    if (slot.fec_k) {
+        slot.group_have[group]++;
+        recover_group(slot, group);
+    }
+    if (slot.received < slot.total_chunks) return false;
+
+    slot.data.resize(static_cast<size_t>(slot.total_chunks - 1) * kChunkPayload + slot.last_chunk_size);
+    out.swap(slot.data);
+    slot.active = false;
+    completed[completed_next] = {true, slot.source, slot.frame_id, now};
+    completed_next = (completed_next + 1) % kCompletedHistory;
+    counters.frames_completed++;
+    return true;
 }
 
 // --- Receiver ---
-QuasarRx::QuasarRx() {
+QuasarRx::QuasarRx(size_t max_in_flight, std::chrono::milliseconds max_age)
+    : reassembler(max_in_flight, max_age), batch(kRecvBatch), batch_sizes(kRecvBatch), batch_peers(kRecvBatch) {
     sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 }
 
@@ -88,43 +503,97 @@ QuasarRx::~QuasarRx() {
     if (sock != INVALID_SOCKET) closesocket(sock);
 }
 
-bool QuasarRx::listen(int port, std::vector<uint8_t>& out_data) {
+bool QuasarRx::bind_port(int port) {
+    if (bound_port == port) return true;
+
     sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
     local.sin_family = AF_INET;
     local.sin_port = htons(port);
     local.sin_addr.s_addr = INADDR_ANY;
-
-    static bool bound = false;
-    if (!bound) {
-        if (bind(sock, (sockaddr*)&local, sizeof(local)) == SOCKET_ERROR) {
-            std::cerr << "[Rx] Bind failed" << std::endl;
-            return false;
-        }
-        bound = true;
+    if (bind(sock, (sockaddr*)&local, sizeof(local)) == SOCKET_ERROR) {
+        std::cerr << "[Rx] Bind failed" << std::endl;
+        return false;
     }
 
-    while (true) {
-        QuasarPacket pkt;
-        sockaddr_in sender;
-        socklen_t addrLen = sizeof(sender);
-        
-        int n = recvfrom(sock, (char*)&pkt, sizeof(pkt), 0, (sockaddr*)&sender, &addrLen);
-        if (n <= 0) continue;
-
-        auto& reasm = frame_buffer[pkt.frame_id];
-        reasm.total_chunks = pkt.total_chunks;
-        
-        std::vector<uint8_t> chunk(pkt.payload, pkt.payload + pkt.data_size);
-        reasm.chunks[pkt.chunk_id] = std::move(chunk);
-
-        if (reasm.chunks.size() == reasm.total_chunks) {
-            std::cout << "[Rx] Completed Frame " << pkt.frame_id << std::endl;
-            out_data.clear();
-            for (uint16_t i = 0; i < reasm.total_chunks; ++i) {
-                out_data.insert(out_data.end(), reasm.chunks[i].begin(), reasm.chunks[i].end());
-            }
-            frame_buffer.erase(pkt.frame_id);
+    // Room for a few frames of bursts from several senders, and a periodic
+    // wake-up so stale frames are expired even when the link goes quiet
+    // (both best effort)
+    int rcvbuf = 16 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, sizeof(rcvbuf));
+#ifdef _WIN32
+    DWORD timeout = 250;
+#else
+    timeval timeout = {0, 250000};
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    bound_port = port;
+    return true;
+}
+
+static Peer peer_from(const sockaddr_in& addr) {
+    return {ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)};
+}
+
+bool QuasarRx::poll(std::vector<uint8_t>& out_data, Peer* from) {
+    // Finish the current batch first: it may hold more than one frame
+    while (batch_pos < batch_count) {
+        size_t i = batch_pos++;
+        const Peer& peer = batch_peers[i];
+        if (reassembler.add(reinterpret_cast<const uint8_t*>(&batch[i]), batch_sizes[i], out_data,
+                            std::chrono::steady_clock::now(), peer.key())) {
+            if (from) *from = peer;
             return true;
         }
     }
+
+    batch_pos = batch_count = 0;
+    sockaddr_in addrs[kRecvBatch];
+#if defined(__linux__)
+    mmsghdr msgs[kRecvBatch];
+    iovec iov[kRecvBatch];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < kRecvBatch; ++i) {
+        iov[i] = {&batch[i], sizeof(QuasarPacket)};
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    }
+    int n = recvmmsg(sock, msgs, kRecvBatch, MSG_WAITFORONE, nullptr);
+    for (int i = 0; i < n; ++i) {
+        // Oversized datagrams are not ours; a zero size marks them malformed
+        batch_sizes[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : msgs[i].msg_len;
+        batch_peers[i] = peer_from(addrs[i]);
+    }
+#else
+    socklen_t addr_len = sizeof(addrs[0]);
+    int n = recvfrom(sock, (char*)&batch[0], sizeof(QuasarPacket), 0, (sockaddr*)&addrs[0], &addr_len);
+    if (n > 0) {
+        batch_sizes[0] = static_cast<size_t>(n);
+        batch_peers[0] = peer_from(addrs[0]);
+    }
+    n = n > 0 ? 1 : 0;
+#endif
+    if (n > 0) {
+        batch_count = static_cast<size_t>(n);
+    } else {
+        reassembler.expire(); // Timeout or error: just age out stale frames
+    }
+    return false;
+}
+
+bool QuasarRx::listen(int port, std::vector<uint8_t>& out_data, Peer* from) {
+    if (!bind_port(port)) return false;
+    while (!poll(out_data, from)) {}
+    return true;
+}
+
+bool QuasarRx::receive(int port, std::vector<uint8_t>& out_data, Peer& from, std::chrono::milliseconds timeout) {
+    if (!bind_port(port)) return false;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    do {
+        if (poll(out_data, &from)) return true;
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
 }
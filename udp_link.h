@@ -4,26 +4,116 @@
 #include <vector>
 #include <string>
 #include <cstdint>
-#include <map>
+#include <cstddef>
+#include <chrono>
+#include <span>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+#endif
+
+// Chunk wire revision, carried as the first byte of every chunk. Receivers
+// drop chunks of any other revision as malformed.
+//   1: frame_id, chunk_id, total_chunks, data_size (no version byte)
+//   2: Version byte first; fec_k/fec_m, parity chunks after the data
+constexpr uint8_t kChunkVersion = 2;
 
 // MTU-safe packet structure (1400 bytes payload)
+//
+// With FEC, data chunks are split into groups of fec_k consecutive chunks
+// (the last group may be shorter) and each group is followed on the wire by
+// fec_m parity chunks. Parity chunk n of the frame has chunk_id
+// total_chunks + n and belongs to group n / fec_m; its payload is always a
+// full 1400 bytes, and its data_size carries the size of the frame's last
+// data chunk so that chunk can be rebuilt too.
 #pragma pack(push, 1)
+struct QuasarChunkHeader {
+    uint8_t version;        // kChunkVersion
+    uint32_t frame_id;      // Unique ID for the whole image
+    uint16_t chunk_id;      // Slice number (0, 1, 2...); parity after the data
+    uint16_t total_chunks;  // Total data slices in this frame
+    uint16_t data_size;     // Size of current payload
+    uint8_t fec_k;          // Data chunks per FEC group (0 = no FEC)
+    uint8_t fec_m;          // Parity chunks per FEC group
+};
+
 struct QuasarPacket {
+    uint8_t version;        // kChunkVersion
     uint32_t frame_id;      // Unique ID for the whole image
-    uint16_t chunk_id;      // Slice number (0, 1, 2...)
-    uint16_t total_chunks;  // Total slices in this frame
+    uint16_t chunk_id;      // Slice number (0, 1, 2...); parity after the data
+    uint16_t total_chunks;  // Total data slices in this frame
     uint16_t data_size;     // Size of current payload
+    uint8_t fec_k;          // Data chunks per FEC group (0 = no FEC)
+    uint8_t fec_m;          // Parity chunks per FEC group
     uint8_t payload[1400];  // Raw data slice
 };
 #pragma pack(pop)
 
+constexpr size_t kChunkPayload = sizeof(QuasarPacket::payload);
+static_assert(sizeof(QuasarChunkHeader) + kChunkPayload == sizeof(QuasarPacket), "chunk header must prefix QuasarPacket");
+
+// Token-bucket pacer: up to `burst` bytes may go out back to back, after
+// which sending is held to `rate` bytes per second. Borrowing is allowed, so
+// the long-run rate stays exact even though sleeps are coarse.
+class TokenBucket {
+public:
+    void configure(uint64_t bytes_per_second, size_t burst_bytes);
+    // Blocks until `bytes` may be sent (no-op when the rate is 0 = unpaced)
+    void acquire(size_t bytes);
+private:
+    double rate = 0.0;
+    double burst = 0.0;
+    double tokens = 0.0;
+    std::chrono::steady_clock::time_point last;
+};
+
 class QuasarTx {
 public:
     QuasarTx();
     ~QuasarTx();
+
+    // Pace transmission to `bits_per_second` (0 = as fast as the socket
+    // accepts), allowing bursts of `burst_bytes`
+    void set_pacing(uint64_t bits_per_second, size_t burst_bytes = 64 * 1024);
+
+    // UDP generic segmentation offload (Linux 4.18+): hands the kernel one
+    // large datagram per batch entry and lets it cut the chunks. Returns
+    // false (and stays off) where the kernel does not support it.
+    bool set_gso(bool enable);
+
+    // Reed-Solomon FEC: `parity` parity chunks for every `data` data chunks,
+    // so any `data` of a group's data + parity chunks rebuild it. (0, 0)
+    // turns FEC off. Returns false for an invalid combination
+    // (data + parity must be at most 256).
+    bool set_fec(int data, int parity);
+
+    // Sends the frame as 1400-byte chunks. Payloads are referenced in place
+    // through scatter-gather iovecs (no per-chunk copy) and submitted in
+    // batches with sendmmsg on Linux.
     void send_frame(const std::vector<uint8_t>& full_data, const std::string& ip, int port);
+
+    // The same for a frame held in three pieces (e.g. archive header,
+    // payload and tag) that are sent back to back as one frame. Only the
+    // chunks that cross from one piece into the next are copied.
+    void send_frame(std::span<const uint8_t> head, std::span<const uint8_t> body, std::span<const uint8_t> tail,
+                    const std::string& ip, int port);
 private:
     uint32_t frame_counter;
+    TokenBucket pacer;
+    bool gso = false;
+    uint8_t fec_k = 0, fec_m = 0;
+    std::vector<QuasarChunkHeader> headers;  // Reused across frames
+    std::vector<uint8_t> parity;             // Parity payloads, reused across frames
+    std::vector<const uint8_t*> chunk_data;  // Start of each data chunk's payload
+    std::vector<uint8_t> straddle;           // Chunks crossing a piece boundary
+#ifndef _WIN32
+    std::vector<iovec> iov;                  // Header and payload of every chunk
+#endif
+#if defined(__linux__)
+    std::vector<mmsghdr> msgs;               // sendmmsg entries, reused across frames
+    std::vector<size_t> message_bytes;       // Wire bytes of each entry, for pacing
+#endif
 #ifdef _WIN32
     uintptr_t sock;
 #else
@@ -31,17 +121,135 @@ private:
 #endif
 };
 
+// Sender of a datagram: IPv4 address and UDP port, host byte order
+struct Peer {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    uint64_t key() const { return (static_cast<uint64_t>(ip) << 16) | port; }
+    std::string to_string() const;  // "a.b.c.d:port"
+};
+
+// Receive-side counters
+struct RxStats {
+    uint64_t packets = 0;           // Datagrams accepted into a frame
+    uint64_t frames_completed = 0;
+    uint64_t frames_evicted = 0;    // Incomplete frames dropped (LRU or age)
+    uint64_t chunks_lost = 0;       // Chunks missing from evicted frames
+    uint64_t chunks_recovered = 0;  // Data chunks rebuilt from FEC parity
+    uint64_t duplicates = 0;        // Repeated chunks, or chunks of finished frames
+    uint64_t malformed = 0;         // Bad sizes/indices, or frames over the size limit
+};
+
+/**
+ * Bounded-memory frame reassembly.
+ *
+ * At most `max_frames` frames are in flight, each in a slot that owns one
+ * contiguous slab: a chunk is copied straight to offset chunk_id * 1400 and
+ * marked in an arrival bitmap, so there is no per-chunk allocation. Frames
+ * are keyed by (source, frame_id), so two drones that happen to pick the
+ * same frame id never mix their chunks. When a
+ * new frame needs a slot and none is free, the least recently updated frame
+ * is evicted; frames idle for longer than `max_age` are evicted too. Slabs
+ * are kept across frames, so steady-state reception does not allocate.
+ *
+ * Memory is bounded by `max_total_bytes` across all slabs, not just per
+ * frame: a frame that would take the total over the budget first releases
+ * idle slabs, then evicts the least recently updated frames. Slabs larger
+ * than a slot's even share of the budget are released when their frame is
+ * evicted, so a few forged chunk counts cannot pin memory.
+ *
+ * FEC parity chunks are kept in a second slab; as soon as a group has as
+ * many chunks as it has data chunks, its missing data chunks are rebuilt in
+ * place. Parity arriving after its group (or frame) is complete is ignored.
+ */
+class FrameReassembler {
+public:
+    explicit FrameReassembler(size_t max_frames = 8,
+                              std::chrono::milliseconds max_age = std::chrono::milliseconds(2000),
+                              size_t max_frame_bytes = 16u << 20, size_t max_total_bytes = 64u << 20);
+
+    // Adds one datagram from `source` (e.g. Peer::key()). Returns true when it
+    // completes a frame; the frame is swapped into `out` (whose old buffer
+    // becomes the slot's next slab).
+    bool add(const uint8_t* datagram, size_t len, std::vector<uint8_t>& out,
+             std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(), uint64_t source = 0);
+
+    // Evicts frames not updated within max_age
+    void expire(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    const RxStats& stats() const { return counters; }
+
+private:
+    struct Slot {
+        bool active = false;
+        uint64_t source = 0;
+        uint32_t frame_id = 0;
+        uint16_t total_chunks = 0;
+        uint16_t received = 0;           // Data chunks present
+        uint8_t fec_k = 0, fec_m = 0;
+        size_t last_chunk_size = 0;
+        std::vector<uint8_t> data;       // Slab: total_chunks * 1400 bytes
+        std::vector<uint8_t> parity;     // Parity slab: groups * fec_m * 1400 bytes
+        std::vector<uint64_t> arrived;   // One bit per chunk, data then parity
+        std::vector<uint16_t> group_have; // Chunks (data + parity) per FEC group
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    Slot& slot_for(uint64_t source, const QuasarChunkHeader& h, std::chrono::steady_clock::time_point now);
+    void evict(Slot& slot);
+    void make_room(Slot& slot, size_t bytes);
+    void recover_group(Slot& slot, size_t group);
+    bool recently_completed(uint64_t source, uint32_t frame_id, std::chrono::steady_clock::time_point now) const;
+
+    std::vector<Slot> slots;
+    std::chrono::milliseconds max_age;
+    size_t max_frame_bytes;
+    size_t max_total_bytes;
+    // Recently finished frames, so their late duplicates do not open a slot
+    struct Completed {
+        bool valid = false;
+        uint64_t source = 0;
+        uint32_t frame_id = 0;
+        std::chrono::steady_clock::time_point when;
+    };
+    static constexpr size_t kCompletedHistory = 64;
+    Completed completed[kCompletedHistory];
+    size_t completed_next = 0;
+    RxStats counters;
+};
+
 class QuasarRx {
 public:
-    QuasarRx();
+    explicit QuasarRx(size_t max_in_flight = 8,
+                      std::chrono::milliseconds max_age = std::chrono::milliseconds(2000));
     ~QuasarRx();
-    bool listen(int port, std::vector<uint8_t>& out_data);
+
+    // Binds the socket (once per port); returns false if the port is taken
+    bool bind_port(int port);
+
+    // Blocks until a frame completes, reporting its sender in `from` if
+    // given. Datagrams are pulled in batches with recvmmsg on Linux; a batch
+    // that completes one frame is resumed by the next call.
+    bool listen(int port, std::vector<uint8_t>& out_data, Peer* from = nullptr);
+
+    // Like listen, but gives up (returning false) once `timeout` passes
+    // without a completed frame. Waits are rounded up to the socket's
+    // 250 ms receive timeout.
+    bool receive(int port, std::vector<uint8_t>& out_data, Peer& from, std::chrono::milliseconds timeout);
+
+    const RxStats& stats() const { return reassembler.stats(); }
 private:
-    struct FrameReassembler {
-        uint16_t total_chunks;
-        std::map<uint16_t, std::vector<uint8_t>> chunks;
-    };
-    std::map<uint32_t, FrameReassembler> frame_buffer;
+    // Feeds the pending batch to the reassembler, or receives the next one
+    // (waiting up to the socket timeout). Returns true when a frame completes.
+    bool poll(std::vector<uint8_t>& out_data, Peer* from);
+
+    FrameReassembler reassembler;
+    std::vector<QuasarPacket> batch;     // Receive buffers, one per datagram
+    std::vector<size_t> batch_sizes;
+    std::vector<Peer> batch_peers;
+    size_t batch_count = 0, batch_pos = 0;
+    int bound_port = -1;
 #ifdef _WIN32
     uintptr_t sock;
 #else
@@ -0,0 +1,28 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <vector>
+#include <cstdint>
+
+// LEB128 unsigned varints: 7 bits per byte, low group first, high bit = more.
+
+inline void writeVarint(uint64_t value, std::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Advances p past the varint. Returns false if it runs past `end` or overflows.
+inline bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        value |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+#endif // VARINT_H
@@ -1,257 +1,451 @@
 #include "wavelet.h"
+#include "haar_kernels.h"
+#include "quant_kernels.h"
+#include "bit_io.h"
 #include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <string>
 #include <cmath>
+#include <bit>
 
-#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
-#include <immintrin.h>
-#endif
+namespace {
+
+// Columns processed together by the tiled column pass. 16 floats is one
+// 64-byte cache line per row, i.e. two AVX2 vectors or four NEON vectors.
+constexpr int kColumnBlock = 16;
+
+// Forward Haar on a contiguous line: line[0..size) -> temp, then back into line.
+// An odd trailing sample is passed through untouched.
+void haarLine(const HaarKernels& k, float* line, int size, float* temp) {
+    if (size < 2) return;
+    int h = size / 2;
+    k.forwardRow(line, temp, temp + h, h);
+    std::copy(temp, temp + 2 * h, line);
+}
+
+void invHaarLine(const HaarKernels& k, float* line, int size, float* temp) {
+    if (size < 2) return;
+    int h = size / 2;
+    k.inverseRow(line, line + h, temp, h);
+    std::copy(temp, temp + 2 * h, line);
+}
 
 /**
- * AVX2 Optimized Haar 1D Transform
- * 
- * Shuffle Logic (De-interleaving):
- * We start with 8 floats in a YMM register: [a0, b0, a1, b1, a2, b2, a3, b3]
- * We use _mm256_permutevar8x32_ps with indices [0, 2, 4, 6, 1, 3, 5, 7]
- * This separates the vector into two 128-bit halves:
- *   Low 128-bit:  [a0, a1, a2, a3] (Even pixels / A)
- *   High 128-bit: [b0, b1, b2, b3] (Odd pixels / B)
- * We then compute Avg = (A+B)*0.5 and Diff = (A-B) in parallel.
+ * Tiled column pass.
+ *
+ * A naive column transform walks the image with stride `width`, touching a
+ * new cache line (and, on 4K frames, often a new page) for every sample.
+ * Instead we take a block of BW adjacent columns and, for each pair of rows,
+ * load BW contiguous floats from both rows. The averages/details land in a
+ * BW-wide tile (`tile`, `height` rows) which is then copied back row by row.
+ * Every memory access is a contiguous BW-float run, so the SIMD kernels
+ * see full vectors and the image is streamed through the cache exactly twice.
+ *
+ * BW is the block width (kColumnBlock for full blocks) or 0 for the
+ * runtime-width tail `bw`. Tile rows always use a kColumnBlock pitch.
  */
-#if defined(__AVX2__)
-void haar1D_AVX2(const std::vector<float>& line, std::vector<float>& temp, int h) {
-    int i = 0;
-    __m256i mask = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
-    __m256 half = _mm256_set1_ps(0.5f);
-
-    for (; i <= h - 4; i += 4) {
-        // Load 8 floats (4 pairs)
-        __m256 v = _mm256_loadu_ps(&line[i * 2]);
-        
-        // De-interleave
-        __m256 perm = _mm256_permutevar8x32_ps(v, mask);
-        
-        // Extract evens and odds
-        __m128 evens = _mm256_extractf128_ps(perm, 0);
-        __m128 odds  = _mm256_extractf128_ps(perm, 1);
-        
-        // Math
-        __m128 avgs = _mm_mul_ps(_mm_add_ps(evens, odds), _mm_set1_ps(0.5f));
-        __m128 diffs = _mm_sub_ps(evens, odds);
-        
-        // Store
-        _mm_storeu_ps(&temp[i], avgs);
-        _mm_storeu_ps(&temp[h + i], diffs);
+template <int BW>
+void haarColumnBlock(const HaarKernels& k, float* data, int stride, int height, int bw, float* tile) {
+    const int h = height / 2;
+    for (int y = 0; y < h; ++y) {
+        const float* a = data + (2 * y) * stride;
+        k.forwardPair(a, a + stride, tile + y * kColumnBlock, tile + (h + y) * kColumnBlock, BW ? BW : bw);
     }
-    
-    // Tail handling
-    for (; i < h; ++i) {
-        float a = line[2 * i];
-        float b = line[2 * i + 1];
-        temp[i] = (a + b) / 2.0f;
-        temp[h + i] = (a - b);
+    for (int y = 0; y < 2 * h; ++y) {
+        const float* src = tile + y * kColumnBlock;
+        std::copy(src, src + (BW ? BW : bw), data + y * stride);
     }
 }
-#endif
-
-void haar1D(std::vector<float>& line, int size) {
-    if (size < 2) return;
 
-    std::vector<float> temp(size);
-    int h = size / 2;
+template <int BW>
+void invHaarColumnBlock(const HaarKernels& k, float* data, int stride, int height, int bw, float* tile) {
+    const int h = height / 2;
+    for (int y = 0; y < h; ++y) {
+        float* a = tile + (2 * y) * kColumnBlock;
+        k.inversePair(data + y * stride, data + (h + y) * stride, a, a + kColumnBlock, BW ? BW : bw);
+    }
+    for (int y = 0; y < 2 * h; ++y) {
+        const float* src = tile + y * kColumnBlock;
+        std::copy(src, src + (BW ? BW : bw), data + y * stride);
+    }
+}
 
-#if defined(__AVX2__)
-    haar1D_AVX2(line, temp, h);
-#else
-    for (int i = 0; i < h; ++i) {
-        float a = line[2 * i];
-        float b = line[2 * i + 1];
-        temp[i] = (a + b) / 2.0f;
-        temp[h + i] = (a - b);
+void haarColumns(const HaarKernels& k, float* data, int stride, int width, int height, float* tile) {
+    if (height < 2) return;
+    int x = 0;
+    for (; x + kColumnBlock <= width; x += kColumnBlock) {
+        haarColumnBlock<kColumnBlock>(k, data + x, stride, height, kColumnBlock, tile);
     }
-#endif
+    if (x < width) {
+        haarColumnBlock<0>(k, data + x, stride, height, width - x, tile);
+    }
+}
 
-    // Copy back
-    for (int i = 0; i < size; ++i) {
-        line[i] = temp[i];
+void invHaarColumns(const HaarKernels& k, float* data, int stride, int width, int height, float* tile) {
+    if (height < 2) return;
+    int x = 0;
+    for (; x + kColumnBlock <= width; x += kColumnBlock) {
+        invHaarColumnBlock<kColumnBlock>(k, data + x, stride, height, kColumnBlock, tile);
+    }
+    if (x < width) {
+        invHaarColumnBlock<0>(k, data + x, stride, height, width - x, tile);
     }
 }
 
-void invHaar1D(std::vector<float>& line, int size) {
+// One scratch allocation serves every row and every column tile of a transform.
+size_t scratchSize(int width, int height) {
+    return std::max<size_t>(width, static_cast<size_t>(height) * kColumnBlock);
+}
+
+} // namespace
+
+void haar1D(std::vector<float>& line, int size) {
     if (size < 2) return;
+    std::vector<float> temp(size);
+    haarLine(haarKernels(), line.data(), size, temp.data());
+}
 
+void invHaar1D(std::vector<float>& line, int size) {
+    if (size < 2) return;
     std::vector<float> temp(size);
-    int h = size / 2;
+    invHaarLine(haarKernels(), line.data(), size, temp.data());
+}
+
+std::vector<Subband> subbandLayout(int width, int height, int levels) {
+    std::vector<Subband> bands;
+    subbandLayout(width, height, levels, bands);
+    return bands;
+}
 
-    for (int i = 0; i < h; ++i) {
-        float avg = line[i];
-        float detail = line[h + i];
+void subbandLayout(int width, int height, int levels, std::vector<Subband>& bands) {
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(width, height)));
+    bands.clear();
 
-        // Reconstruction:
-        // a = avg + detail / 2
-        // b = avg - detail / 2
-        temp[2 * i] = avg + detail / 2.0f;
-        temp[2 * i + 1] = avg - detail / 2.0f;
+    int llW = width >> levels, llH = height >> levels;
+    bands.push_back({0, 0, llW, llH, levels, Subband::LL});
+    for (int level = levels; level >= 1; --level) {
+        // Region transformed at this level and its low-pass half
+        int w = width >> (level - 1), h = height >> (level - 1);
+        int hw = w / 2, hh = h / 2;
+        bands.push_back({hw, 0, w - hw, hh, level, Subband::HL});
+        bands.push_back({0, hh, hw, h - hh, level, Subband::LH});
+        bands.push_back({hw, hh, w - hw, h - hh, level, Subband::HH});
     }
+}
 
-    for (int i = 0; i < size; ++i) {
-        line[i] = temp[i];
+int maxWaveletLevels(int width, int height) {
+    int levels = 0;
+    while (width >= 2 && height >= 2) {
+        width /= 2;
+        height /= 2;
+        levels++;
     }
+    return levels;
 }
 
-void transform2D(GrayImage& img) {
-    // 1. Transform Rows
-    for (int y = 0; y < img.height; ++y) {
-        std::vector<float> row(img.width);
-        for (int x = 0; x < img.width; ++x) {
-            row[x] = img.data[y * img.width + x];
-        }
-        haar1D(row, img.width);
-        for (int x = 0; x < img.width; ++x) {
-            img.data[y * img.width + x] = row[x];
+/**
+ * Multi-level (dyadic) decomposition.
+ *
+ * Level 0 transforms the full frame. Each following level re-transforms only
+ * the top-left LL band of the previous one (w/2 x h/2), leaving the detail
+ * bands in place, so the final layout is the usual Mallat pyramid:
+ *
+ *   +----+----+---------+
+ *   | LL | HL |         |
+ *   +----+----+   HL1   |
+ *   | LH | HH |         |
+ *   +----+----+---------+
+ *   |         |         |
+ *   |   LH1   |   HH1   |
+ *   |         |         |
+ *   +---------+---------+
+ *
+ * All levels share the row stride of the full image and a single scratch buffer.
+ */
+void transform2D(GrayImage& img, int levels) {
+    WaveletScratch scratch;
+    transform2D(img, levels, scratch);
+}
+
+void transform2D(GrayImage& img, int levels, WaveletScratch& scratch) {
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(img.width, img.height)));
+    const HaarKernels& k = haarKernels();
+    scratch.lines.resize(scratchSize(img.width, img.height));
+    float* temp = scratch.lines.data();
+    float* data = img.data.data();
+
+    int w = img.width, h = img.height;
+    for (int level = 0; level < levels; ++level) {
+        // 1. Transform Rows
+        for (int y = 0; y < h; ++y) {
+            haarLine(k, data + y * img.width, w, temp);
         }
+
+        // 2. Transform Columns (tiled)
+        haarColumns(k, data, img.width, w, h, temp);
+
+        w /= 2;
+        h /= 2;
     }
+}
 
-    // 2. Transform Columns
-    for (int x = 0; x < img.width; ++x) {
-        std::vector<float> col(img.height);
-        for (int y = 0; y < img.height; ++y) {
-            col[y] = img.data[y * img.width + x];
-        }
-        haar1D(col, img.height);
-        for (int y = 0; y < img.height; ++y) {
-            img.data[y * img.width + x] = col[y];
+void inverseTransform2D(GrayImage& img, int levels) {
+    WaveletScratch scratch;
+    inverseTransform2D(img, levels, scratch);
+}
+
+void inverseTransform2D(GrayImage& img, int levels, WaveletScratch& scratch) {
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(img.width, img.height)));
+    const HaarKernels& k = haarKernels();
+    scratch.lines.resize(scratchSize(img.width, img.height));
+    float* temp = scratch.lines.data();
+    float* data = img.data.data();
+
+    // Undo the coarsest level first
+    for (int level = levels - 1; level >= 0; --level) {
+        int w = img.width >> level;
+        int h = img.height >> level;
+
+        // 1. Inverse Columns (tiled)
+        invHaarColumns(k, data, img.width, w, h, temp);
+
+        // 2. Inverse Rows
+        for (int y = 0; y < h; ++y) {
+            invHaarLine(k, data + y * img.width, w, temp);
         }
     }
 }
 
-void inverseTransform2D(GrayImage& img) {
-    // 1. Inverse Columns
-    for (int x = 0; x < img.width; ++x) {
-        std::vector<float> col(img.height);
-        for (int y = 0; y < img.height; ++y) {
-            col[y] = img.data[y * img.width + x];
+namespace {
+
+// buildRoiMask into existing storage: `mask` and `row` (one row's unmerged
+// spans) keep their capacity from the previous frame
+void rasterizeRoiMask(const std::vector<ROI>& targets, int width, int height, int level, float falloff,
+                      int originX, int originY, SpanMask& mask, std::vector<std::pair<int, int>>& row) {
+    mask.width = (width + (1 << level) - 1) >> level;
+    mask.height = (height + (1 << level) - 1) >> level;
+    mask.rowStart.assign(mask.height + 1, 0);
+    mask.spans.clear();
+
+    // A level-l coefficient covers a 2^l x 2^l block of pixels. Measuring from
+    // the block centre, widening the disc by the block's half-diagonal keeps
+    // every coefficient whose support touches the ROI.
+    const float cell = static_cast<float>(1 << level);
+    const float halfCell = (cell - 1.0f) * 0.5f;
+    const float margin = halfCell * 1.41421356f;
+
+    for (int j = 0; j < mask.height; ++j) {
+        row.clear();
+        for (const ROI& roi : targets) {
+            float cx = (roi.x - originX - halfCell) / cell;
+            float cy = (roi.y - originY - halfCell) / cell;
+            float radius = (roi.r + falloff + margin) / cell;
+            float dy = j - cy;
+            if (dy * dy > radius * radius) continue;
+            float half = std::sqrt(radius * radius - dy * dy);
+            int x0 = std::max(0, static_cast<int>(std::ceil(cx - half)));
+            int x1 = std::min(mask.width, static_cast<int>(std::floor(cx + half)) + 1);
+            if (x0 < x1) row.push_back({x0, x1});
         }
-        invHaar1D(col, img.height);
-        for (int y = 0; y < img.height; ++y) {
-            img.data[y * img.width + x] = col[y];
+
+        // Sort and merge overlapping discs into disjoint spans
+        std::sort(row.begin(), row.end());
+        for (const auto& span : row) {
+            if (mask.spans.size() > mask.rowStart[j] && span.first <= mask.spans.back().second) {
+                mask.spans.back().second = std::max(mask.spans.back().second, span.second);
+            } else {
+                mask.spans.push_back(span);
+            }
         }
+        mask.rowStart[j + 1] = static_cast<uint32_t>(mask.spans.size());
     }
+}
 
-    // 2. Inverse Rows
-    for (int y = 0; y < img.height; ++y) {
-        std::vector<float> row(img.width);
-        for (int x = 0; x < img.width; ++x) {
-            row[x] = img.data[y * img.width + x];
-        }
-        invHaar1D(row, img.width);
-        for (int x = 0; x < img.width; ++x) {
-            img.data[y * img.width + x] = row[x];
+// Zeroes a row of `n` samples outside the mask spans of `maskRow`
+void maskRow(float* row, int n, const SpanMask& mask, int maskRow) {
+    int x = 0;
+    if (maskRow < mask.height) {
+        for (uint32_t s = mask.rowStart[maskRow]; s < mask.rowStart[maskRow + 1]; ++s) {
+            int x0 = std::min(mask.spans[s].first, n);
+            std::fill(row + x, row + x0, 0.0f);
+            x = std::max(x, std::min(mask.spans[s].second, n));
         }
     }
+    std::fill(row + x, row + n, 0.0f);
 }
 
-bool loadPGM(const std::string& path, GrayImage& img) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) return false;
+} // namespace
 
-    std::string format;
-    int maxVal;
-    file >> format >> img.width >> img.height >> maxVal;
-    
-    // Skip single whitespace after maxVal
-    file.ignore(1);
-
-    if (format != "P5") return false;
+SpanMask buildRoiMask(const std::vector<ROI>& targets, int width, int height, int level, float falloff,
+                      int originX, int originY) {
+    SpanMask mask;
+    std::vector<std::pair<int, int>> row;
+    rasterizeRoiMask(targets, width, height, level, falloff, originX, originY, mask, row);
+    return mask;
+}
 
-    img.data.assign(img.width * img.height, 0.0f);
-    std::vector<uint8_t> buffer(img.width * img.height);
-    file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+void applySaliency(GrayImage& img, const std::vector<ROI>& targets) {
+    if (targets.empty()) return;
 
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        img.data[i] = static_cast<float>(buffer[i]);
+    SpanMask mask = buildRoiMask(targets, img.width, img.height, 0);
+    for (int y = 0; y < img.height; ++y) {
+        maskRow(img.data.data() + static_cast<size_t>(y) * img.width, img.width, mask, y);
     }
-    return true;
 }
 
-bool savePGM(const std::string& path, const GrayImage& img) {
-    std::ofstream file(path, std::ios::binary);
-    if (!file) return false;
+void applySubbandSaliency(GrayImage& img, const std::vector<ROI>& targets, int levels, float falloff,
+                          int originX, int originY) {
+    WaveletScratch scratch;
+    applySubbandSaliency(img, targets, levels, falloff, originX, originY, scratch);
+}
 
-    file << "P5\n" << img.width << " " << img.height << "\n255\n";
+void applySubbandSaliency(GrayImage& img, const std::vector<ROI>& targets, int levels, float falloff,
+                          int originX, int originY, WaveletScratch& scratch) {
+    if (targets.empty()) return;
+    levels = std::clamp(levels, 1, std::max(1, maxWaveletLevels(img.width, img.height)));
+    falloff = std::max(falloff, 0.0f);
 
-    std::vector<uint8_t> buffer(img.width * img.height);
-    for (size_t i = 0; i < img.data.size(); ++i) {
-        float val = std::clamp(img.data[i], 0.0f, 255.0f);
-        buffer[i] = static_cast<uint8_t>(val);
+    if (scratch.masks.size() < static_cast<size_t>(levels) + 1) scratch.masks.resize(levels + 1);
+    for (int l = 1; l <= levels; ++l) {
+        rasterizeRoiMask(targets, img.width, img.height, l, falloff, originX, originY, scratch.masks[l], scratch.spans);
     }
-    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    return true;
-}
 
-void applySaliency(GrayImage& img, const std::vector<ROI>& targets) {
-    if (targets.empty()) return;
+    subbandLayout(img.width, img.height, levels, scratch.bands);
+    for (const Subband& band : scratch.bands) {
+        const SpanMask& mask = scratch.masks[band.level];
+        const float cell = static_cast<float>(1 << band.level);
+        const float halfCell = (cell - 1.0f) * 0.5f;
+        const float margin = halfCell * 1.41421356f;
 
-    for (int y = 0; y < img.height; ++y) {
-        for (int x = 0; x < img.width; ++x) {
-            bool in_any_roi = false;
-            
-            // Check if this pixel is inside ANY of the target bubbles
-            for (const auto& roi : targets) {
-                float dx = (float)x - (float)roi.x;
-                float dy = (float)y - (float)roi.y;
-                if ((dx * dx + dy * dy) <= (float)roi.r * (float)roi.r) {
-                    in_any_roi = true;
-                    break; 
+        for (int j = 0; j < band.height; ++j) {
+            float* row = img.data.data() + static_cast<size_t>(band.y + j) * img.width + band.x;
+            maskRow(row, band.width, mask, j);
+            if (falloff <= 0.0f || j >= mask.height) continue;
+
+            // Foveation: inside the spans, fade coefficients linearly from the
+            // ROI edge out to `falloff` pixels beyond it
+            const float py = j * cell + halfCell + originY;
+            for (uint32_t s = mask.rowStart[j]; s < mask.rowStart[j + 1]; ++s) {
+                int x1 = std::min(mask.spans[s].second, band.width);
+                for (int i = mask.spans[s].first; i < x1; ++i) {
+                    const float px = i * cell + halfCell + originX;
+                    float weight = 0.0f;
+                    for (const ROI& roi : targets) {
+                        float d = std::hypot(px - roi.x, py - roi.y) - margin - roi.r;
+                        weight = std::max(weight, 1.0f - d / falloff);
+                    }
+                    row[i] *= std::min(weight, 1.0f);
                 }
             }
+        }
+    }
+}
 
-            if (!in_any_roi) {
-                img.data[y * img.width + x] = 0.0f;
-            }
+float subbandScale(const Subband& band, float scale, float detailScale) {
+    if (band.orientation == Subband::LL || detailScale <= 0.0f) return scale;
+    return band.orientation == Subband::HH ? detailScale * 0.5f : detailScale;
+}
+
+void quantizeCoefficients(const GrayImage& img, std::span<int32_t> coeffs, float scale, float detailScale, int levels) {
+    WaveletScratch scratch;
+    quantizeCoefficients(img, coeffs, scale, detailScale, levels, scratch);
+}
+
+void quantizeCoefficients(const GrayImage& img, std::span<int32_t> coeffs, float scale, float detailScale, int levels,
+                          WaveletScratch& scratch) {
+    if (coeffs.size() < img.data.size()) return;
+    const QuantKernels& k = quantKernels();
+    subbandLayout(img.width, img.height, levels, scratch.bands);
+    for (const Subband& band : scratch.bands) {
+        const float s = subbandScale(band, scale, detailScale);
+        for (int y = band.y; y < band.y + band.height; ++y) {
+            size_t i = static_cast<size_t>(y) * img.width + band.x;
+            k.quantize(img.data.data() + i, coeffs.data() + i, band.width, s);
         }
     }
 }
 
-std::vector<uint8_t> quantize(const GrayImage& img, float scale) {
-    std::vector<uint8_t> output;
-    // Reserve 4 bytes per pixel
-    output.reserve(img.data.size() * 4);
-
-    for (float val : img.data) {
-        // Upgrade to 32-bit integer to prevent overflow at high scales
-        int32_t quantized = static_cast<int32_t>(std::round(val * scale));
-        
-        // Split into 4 bytes (Big-Endian)
-        output.push_back(static_cast<uint8_t>((quantized >> 24) & 0xFF));
-        output.push_back(static_cast<uint8_t>((quantized >> 16) & 0xFF));
-        output.push_back(static_cast<uint8_t>((quantized >> 8) & 0xFF));
-        output.push_back(static_cast<uint8_t>(quantized & 0xFF));
+std::vector<int32_t> quantizeCoefficients(const GrayImage& img, float scale, float detailScale, int levels) {
+    std::vector<int32_t> coeffs(img.data.size());
+    quantizeCoefficients(img, coeffs, scale, detailScale, levels);
+    return coeffs;
+}
+
+void dequantizeCoefficients(std::span<const int32_t> coeffs, GrayImage& img, float scale, float detailScale, int levels) {
+    // Every pixel belongs to exactly one subband, so no clearing pass is needed;
+    // resize only reallocates when the frame size changes
+    img.data.resize(static_cast<size_t>(img.width) * img.height);
+    if (coeffs.size() < img.data.size()) {
+        std::fill(img.data.begin(), img.data.end(), 0.0f);
+        return;
+    }
+    const QuantKernels& k = quantKernels();
+    for (const Subband& band : subbandLayout(img.width, img.height, levels)) {
+        const float inv = 1.0f / subbandScale(band, scale, detailScale);
+        for (int y = band.y; y < band.y + band.height; ++y) {
+            size_t i = static_cast<size_t>(y) * img.width + band.x;
+            k.dequantize(coeffs.data() + i, img.data.data() + i, band.width, inv);
+        }
     }
-    return output;
 }
 
-void dequantize(const std::vector<uint8_t>& data, GrayImage& img, float scale) {
+// Zigzag folds signed values onto unsigned ones (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...)
+// so zero stays all-zero bits and small magnitudes stay narrow.
+static inline uint32_t zigzag(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t u) {
+    return static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1);
+}
+
+std::vector<uint8_t> quantize(const GrayImage& img, float scale, float detailScale, int levels) {
+    std::vector<int32_t> coeffs = quantizeCoefficients(img, scale, detailScale, levels);
+    BitPacker packer;
+    packer.data.reserve(coeffs.size() * 2);
+
+    for (const Subband& band : subbandLayout(img.width, img.height, levels)) {
+        // Measure the band's dynamic range first
+        int32_t lo = 0, hi = 0;
+        for (int y = band.y; y < band.y + band.height; ++y) {
+            const int32_t* row = coeffs.data() + static_cast<size_t>(y) * img.width;
+            for (int x = band.x; x < band.x + band.width; ++x) {
+                lo = std::min(lo, row[x]);
+                hi = std::max(hi, row[x]);
+            }
+        }
+
+        // Zigzag keeps masked-out zeros as zero bits (long 0x00 runs for the
+        // Huffman stage) at the cost of at most one extra bit over (hi - lo)
+        int width = std::bit_width(std::max(zigzag(lo), zigzag(hi)));
+        packer.write(static_cast<uint32_t>(width), 6);
+        for (int y = band.y; y < band.y + band.height; ++y) {
+            const int32_t* row = coeffs.data() + static_cast<size_t>(y) * img.width;
+            for (int x = band.x; x < band.x + band.width; ++x) {
+                packer.write(zigzag(row[x]), width);
+            }
+        }
+    }
+    packer.flush();
+    return std::move(packer.data);
+}
+
+bool dequantize(std::span<const uint8_t> data, GrayImage& img, float scale, float detailScale, int levels) {
     // We assume the image dimensions are already set in 'img'
-    img.data.assign(img.width * img.height, 0.0f);
-    
-    for (size_t i = 0; i < img.data.size(); ++i) {
-        if (4 * i + 3 >= data.size()) break;
-
-        // Reassemble from 4 bytes
-        uint8_t b3 = data[4 * i];
-        uint8_t b2 = data[4 * i + 1];
-        uint8_t b1 = data[4 * i + 2];
-        uint8_t b0 = data[4 * i + 3];
-        
-        // Cast to uint32_t first to prevent sign extension issues during shift
-        int32_t val = (static_cast<uint32_t>(b3) << 24) |
-                      (static_cast<uint32_t>(b2) << 16) |
-                      (static_cast<uint32_t>(b1) << 8) |
-                      static_cast<uint32_t>(b0);
-                      
-        img.data[i] = static_cast<float>(val) / scale;
+    std::vector<int32_t> coeffs(static_cast<size_t>(img.width) * img.height, 0);
+    BitUnpacker unpacker(data.data(), data.data() + data.size());
+
+    for (const Subband& band : subbandLayout(img.width, img.height, levels)) {
+        uint32_t width = 0;
+        if (!unpacker.read(6, width) || width > 32) return false;
+        for (int y = band.y; y < band.y + band.height; ++y) {
+            int32_t* row = coeffs.data() + static_cast<size_t>(y) * img.width;
+            for (int x = band.x; x < band.x + band.width; ++x) {
+                uint32_t v = 0;
+                if (!unpacker.read(width, v)) return false;
+                row[x] = unzigzag(v);
+            }
+        }
     }
+
+    dequantizeCoefficients(coeffs, img, scale, detailScale, levels);
+    return true;
 }
@@ -1,14 +1,16 @@
 #ifndef WAVELET_H
 #define WAVELET_H
-#include <string>   
 #include <cstdint>
 #include <vector>
+#include <span>
+#include <utility>
 #include "quasar_format.h"
 
 struct GrayImage {
     int width;
     int height;
     std::vector<float> data;
+    int maxVal = 255;   // Sample range [0, maxVal]; above 255 for 16-bit sources
 
     GrayImage(int w, int h) : width(w), height(h), data(w * h, 0.0f) {}
 };
@@ -19,23 +21,104 @@ void haar1D(std::vector<float>& line, int size);
 // Inverse Haar 1D transform
 void invHaar1D(std::vector<float>& line, int size);
 
-// Forward Haar 2D transform (Rows then Columns)
-void transform2D(GrayImage& img);
+// One rectangle of the wavelet pyramid. Together the subbands returned by
+// subbandLayout partition the whole image (odd pass-through rows/columns
+// belong to the detail band next to them).
+struct Subband {
+    enum Orientation : uint8_t { LL = 0, HL = 1, LH = 2, HH = 3 };
 
-// Inverse Haar 2D transform
-void inverseTransform2D(GrayImage& img);
+    int x, y;
+    int width, height;
+    int level;               // 1 = finest detail level, `levels` = coarsest
+    Orientation orientation;
+};
+
+// Subbands of a `levels`-deep transform, coarsest first: LL, then HL/LH/HH
+// from the coarsest level down to the finest
+std::vector<Subband> subbandLayout(int width, int height, int levels);
+void subbandLayout(int width, int height, int levels, std::vector<Subband>& bands);
+
+// Deepest dyadic decomposition an image of this size supports
+int maxWaveletLevels(int width, int height);
+
+// Forward Haar 2D transform (Rows then Columns), repeated on the LL band
+// for `levels` dyadic levels (clamped to maxWaveletLevels)
+void transform2D(GrayImage& img, int levels = 1);
+
+// Inverse Haar 2D transform; `levels` must match the forward transform
+void inverseTransform2D(GrayImage& img, int levels = 1);
+
+// Union of ROI discs rasterized onto a grid, as sorted, disjoint [first, second)
+// column spans per row. Masking walks the spans, so its cost follows the ROI
+// area instead of testing every pixel against every ROI.
+struct SpanMask {
+    int width = 0, height = 0;
+    std::vector<uint32_t> rowStart;            // height + 1 offsets into spans
+    std::vector<std::pair<int, int>> spans;
+};
 
-// PGM File Helpers
-bool loadPGM(const std::string& path, GrayImage& img);
-bool savePGM(const std::string& path, const GrayImage& img);
+// Working storage of the transform, saliency and quantization passes. A
+// caller that processes frame after frame keeps one (see FrameContext) and
+// passes it to the overloads below; the buffers grow to the largest frame
+// seen and are reused from then on, so those passes stop allocating.
+struct WaveletScratch {
+    std::vector<float> lines;                  // Row and column-tile scratch
+    std::vector<Subband> bands;                // Subband layout of the frame
+    std::vector<SpanMask> masks;               // ROI mask per wavelet level
+    std::vector<std::pair<int, int>> spans;    // One mask row being merged
+};
+
+void transform2D(GrayImage& img, int levels, WaveletScratch& scratch);
+void inverseTransform2D(GrayImage& img, int levels, WaveletScratch& scratch);
 
-// Saliency filter: Nullifies coefficients outside a central radius
+// Rasterizes the ROIs onto the coefficient grid of wavelet level `level`
+// (0 = pixels). Discs are grown by `falloff` pixels and, for level > 0, by the
+// footprint of one coefficient, so every coefficient touching an ROI is kept.
+// The grid covers the region whose top-left pixel is (originX, originY) of
+// the frame the ROIs refer to (non-zero for a tile).
+SpanMask buildRoiMask(const std::vector<ROI>& targets, int width, int height, int level, float falloff = 0.0f,
+                      int originX = 0, int originY = 0);
+
+// Saliency filter: Nullifies pixels outside every ROI (before the transform)
 void applySaliency(GrayImage& img, const std::vector<ROI>& targets);
 
-// Quantization: Bridges float coefficients to 16-bit bit-packed data
-std::vector<uint8_t> quantize(const GrayImage& img, float scale);
+// Saliency filter in the wavelet domain: run after transform2D(img, levels).
+// Each subband is masked with the ROIs scaled to its level, so the ROI
+// boundary adds no artificial edge to the detail bands. With falloff > 0,
+// coefficients fade out linearly over `falloff` pixels past the ROI edge
+// (soft foveation) instead of stopping at it. For a tile transformed on its
+// own, (originX, originY) is its position in the frame.
+void applySubbandSaliency(GrayImage& img, const std::vector<ROI>& targets, int levels, float falloff = 0.0f,
+                          int originX = 0, int originY = 0);
+void applySubbandSaliency(GrayImage& img, const std::vector<ROI>& targets, int levels, float falloff,
+                          int originX, int originY, WaveletScratch& scratch);
+
+// Per-subband quantization scale. LL always keeps `scale` (full scientific
+// precision); detail bands use `detailScale`, with HH, the least informative
+// band, at half of it. A detailScale of 0 quantizes every band with `scale`.
+float subbandScale(const Subband& band, float scale, float detailScale);
+
+// Quantization: Bridges float coefficients to bit-packed integers. Every
+// subband is stored as a bit width (6 bits) sized from its min/max, followed
+// by its zigzag-coded values packed at that width, so quiet bands take a few
+// bits per sample instead of 32.
+std::vector<uint8_t> quantize(const GrayImage& img, float scale, float detailScale = 0.0f, int levels = 1);
+
+// Dequantization: Reconstructs float coefficients from bit-packed data.
+// Returns false if the data is truncated.
+bool dequantize(std::span<const uint8_t> data, GrayImage& img, float scale, float detailScale = 0.0f, int levels = 1);
+
+// Coefficient quantization for the coefficient entropy coder:
+// round(v * subband scale), rounding half to even and saturating at
+// +/-2147483520. Writes into caller-provided storage of at least
+// width * height values (nothing is written if it is smaller).
+void quantizeCoefficients(const GrayImage& img, std::span<int32_t> coeffs, float scale, float detailScale = 0.0f, int levels = 1);
+void quantizeCoefficients(const GrayImage& img, std::span<int32_t> coeffs, float scale, float detailScale, int levels,
+                          WaveletScratch& scratch);
+std::vector<int32_t> quantizeCoefficients(const GrayImage& img, float scale, float detailScale = 0.0f, int levels = 1);
 
-// Dequantization: Reconstructs float coefficients from 16-bit data
-void dequantize(const std::vector<uint8_t>& data, GrayImage& img, float scale);
+// Inverse of quantizeCoefficients (multiplies by the reciprocal subband scale)
+// into an image of the matching size. img.data is reused when already sized.
+void dequantizeCoefficients(std::span<const int32_t> coeffs, GrayImage& img, float scale, float detailScale = 0.0f, int levels = 1);
 
 #endif // WAVELET_H